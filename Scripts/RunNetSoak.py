@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Runs a net soak: one headless server plus N headless clients under a packet simulation
+profile from [/Script/Shoot_N_Run.NetSoakSubsystem] in DefaultGame.ini.
+
+The server writes Saved/NetSoak/<Profile>.txt and exits non zero when a threshold is
+exceeded; this script returns that exit code, or 2 when a process crashes or hangs.
+
+    python Scripts/RunNetSoak.py --editor "C:/UE_5.3/Engine/Binaries/Win64/UnrealEditor-Cmd.exe" --profile Bad --clients 5
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+PROJECT_DIR = Path(__file__).resolve().parent.parent
+PROJECT_FILE = PROJECT_DIR / "Shoot_N_Run.uproject"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description="Run the Shoot_N_Run net soak")
+    parser.add_argument("--editor", default=os.environ.get("UE_EDITOR_CMD"),
+                        help="Path to UnrealEditor-Cmd (or set UE_EDITOR_CMD)")
+    parser.add_argument("--profile", default="Average")
+    parser.add_argument("--clients", type=int, default=5)
+    parser.add_argument("--duration", type=float, default=300.0, help="Seconds the server measures for")
+    parser.add_argument("--flood", type=int, default=0, help="Junk RPCs each client sends per frame")
+    parser.add_argument("--map", default="/Game/Levels/FirstLevel")
+    parser.add_argument("--port", type=int, default=7777)
+    return parser.parse_args()
+
+
+def launch(editor, extra_args, log_path):
+    args = [editor, str(PROJECT_FILE)] + extra_args + [
+        "-nullrhi", "-nosound", "-unattended", "-nopause", "-nosplash",
+        "-abslog=" + str(log_path),
+    ]
+    return subprocess.Popen(args, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def stop(process):
+    if process.poll() is None:
+        process.terminate()
+        try:
+            process.wait(timeout=15)
+        except subprocess.TimeoutExpired:
+            process.kill()
+
+
+def main():
+    args = parse_args()
+    if not args.editor:
+        print("Pass --editor or set UE_EDITOR_CMD")
+        return 2
+
+    log_dir = PROJECT_DIR / "Saved" / "NetSoak"
+    log_dir.mkdir(parents=True, exist_ok=True)
+
+    report = log_dir / (args.profile + ".txt")
+    if report.exists():
+        report.unlink()
+
+    soak_args = ["-NetSoak", "-NetSoakProfile=" + args.profile]
+    if args.flood > 0:
+        soak_args.append("-NetSoakFlood=%d" % args.flood)
+
+    server = launch(args.editor,
+                    [args.map, "-server", "-port=%d" % args.port, "-NetSoakDuration=%g" % args.duration] + soak_args,
+                    log_dir / (args.profile + "_Server.log"))
+
+    # Give the server time to load the map before clients connect
+    time.sleep(10)
+
+    # Clients outlive the server and are stopped once its report is written
+    clients = []
+    for index in range(args.clients):
+        clients.append(launch(args.editor,
+                              ["127.0.0.1:%d" % args.port, "-game", "-NetSoakDuration=%g" % (args.duration + 600)] + soak_args,
+                              log_dir / ("%s_Client%d.log" % (args.profile, index))))
+
+    result = 0
+    try:
+        server_code = server.wait(timeout=args.duration + 300)
+    except subprocess.TimeoutExpired:
+        print("Server did not finish the soak in time")
+        stop(server)
+        server_code = 2
+
+    crashed = [index for index, client in enumerate(clients) if client.poll() not in (None, 0)]
+    for client in clients:
+        stop(client)
+
+    if crashed:
+        print("Clients exited early: %s" % ", ".join(str(index) for index in crashed))
+        result = 2
+
+    if report.exists():
+        print(report.read_text())
+    else:
+        print("No report written, see %s" % (log_dir / (args.profile + "_Server.log")))
+        result = 2
+
+    return result or server_code
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -10,6 +10,7 @@ public class Shoot_N_RunTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V4;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_3;
+		bUseIris = true;
 		ExtraModuleNames.Add("Shoot_N_Run");
 	}
 }
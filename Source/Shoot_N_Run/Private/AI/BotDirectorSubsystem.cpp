@@ -0,0 +1,179 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AI/BotDirectorSubsystem.h"
+#include "AI/ShooterBotController.h"
+#include "Shoot_N_Run.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("Bot Director"), STAT_BotDirector, STATGROUP_ShootNRun);
+DECLARE_CYCLE_STAT(TEXT("Bot Steering"), STAT_BotSteering, STATGROUP_ShootNRun);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Bot Perception Time (us)"), STAT_BotPerceptionUs, STATGROUP_ShootNRun);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bots"), STAT_Bots, STATGROUP_ShootNRun);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Perception Updates"), STAT_BotPerceptionUpdates, STATGROUP_ShootNRun);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Path Requests"), STAT_BotPathRequests, STATGROUP_ShootNRun);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bot Paths In Flight"), STAT_BotPathsInFlight, STATGROUP_ShootNRun);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool UBotDirectorSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UBotDirectorSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!bEnableBackfill || !GetWorld()->GetAuthGameMode())
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_BotDirector);
+
+    TimeSinceBackfill += DeltaTime;
+    if (TimeSinceBackfill >= BackfillInterval)
+    {
+        TimeSinceBackfill = 0.0f;
+        UpdateBackfill();
+    }
+
+    if (Bots.Num() == 0)
+    {
+        return;
+    }
+
+    {
+        SCOPE_CYCLE_COUNTER(STAT_BotSteering);
+        for (AShooterBotController* Bot : Bots)
+        {
+            if (IsValid(Bot))
+            {
+                Bot->TickBot(DeltaTime);
+            }
+        }
+    }
+
+    const float Now = GetWorld()->GetTimeSeconds();
+    TickPerception(Now);
+    TickPathRequests(Now);
+
+    SET_DWORD_STAT(STAT_Bots, Bots.Num());
+}
+
+TStatId UBotDirectorSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UBotDirectorSubsystem, STATGROUP_Tickables);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Keep humans plus bots at LobbySize while at least one human is playing
+void UBotDirectorSubsystem::UpdateBackfill()
+{
+    Bots.RemoveAll([](const AShooterBotController* Bot) { return !IsValid(Bot); });
+
+    AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+    const int32 NumHumans = GameMode->GetNumPlayers();
+    const int32 WantedBots = NumHumans > 0 ? FMath::Max(0, LobbySize - NumHumans) : 0;
+
+    while (Bots.Num() > WantedBots)
+    {
+        AShooterBotController* Bot = Bots.Pop();
+        if (APawn* Pawn = Bot->GetPawn())
+        {
+            Pawn->Destroy();
+        }
+        Bot->Destroy();
+    }
+
+    // Killed bots keep their controller, put them back in the match
+    for (AShooterBotController* Bot : Bots)
+    {
+        if (!Bot->GetPawn())
+        {
+            GameMode->RestartPlayer(Bot);
+        }
+    }
+
+    if (Bots.Num() < WantedBots)
+    {
+        UClass* Class = BotControllerClass.IsNull() ? AShooterBotController::StaticClass() : BotControllerClass.LoadSynchronous();
+
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+        while (Bots.Num() < WantedBots)
+        {
+            AShooterBotController* Bot = GetWorld()->SpawnActor<AShooterBotController>(Class, SpawnParams);
+            if (!Bot)
+            {
+                break;
+            }
+
+            GameMode->RestartPlayer(Bot);
+            if (!Bot->GetPawn())
+            {
+                Bot->Destroy();
+                break;
+            }
+
+            Bots.Add(Bot);
+        }
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Visit bots round robin until the budget is spent, the cursor carries over to the next frame
+void UBotDirectorSubsystem::TickPerception(float Now)
+{
+    const double BudgetSeconds = PerceptionBudgetUs * 1e-6;
+    const double StartTime = FPlatformTime::Seconds();
+
+    int32 NumUpdated = 0;
+    for (int32 Visited = 0; Visited < Bots.Num() && FPlatformTime::Seconds() - StartTime < BudgetSeconds; ++Visited)
+    {
+        PerceptionCursor = (PerceptionCursor + 1) % Bots.Num();
+
+        AShooterBotController* Bot = Bots[PerceptionCursor];
+        if (IsValid(Bot) && Bot->IsPerceptionDue(Now))
+        {
+            Bot->UpdatePerception(Now);
+            ++NumUpdated;
+        }
+    }
+
+    SET_DWORD_STAT(STAT_BotPerceptionUpdates, NumUpdated);
+    SET_FLOAT_STAT(STAT_BotPerceptionUs, (FPlatformTime::Seconds() - StartTime) * 1e6);
+}
+
+void UBotDirectorSubsystem::TickPathRequests(float Now)
+{
+    int32 NumStarted = 0;
+    int32 NumInFlight = 0;
+    for (int32 Visited = 0; Visited < Bots.Num(); ++Visited)
+    {
+        PathCursor = (PathCursor + 1) % Bots.Num();
+
+        AShooterBotController* Bot = Bots[PathCursor];
+        if (!IsValid(Bot))
+        {
+            continue;
+        }
+
+        if (NumStarted < MaxPathRequestsPerFrame && Bot->WantsPath(Now))
+        {
+            Bot->RequestPath(Now);
+            ++NumStarted;
+        }
+
+        NumInFlight += Bot->IsPathInFlight() ? 1 : 0;
+    }
+
+    SET_DWORD_STAT(STAT_BotPathRequests, NumStarted);
+    SET_DWORD_STAT(STAT_BotPathsInFlight, NumInFlight);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AI/ShooterBotController.h"
+#include "Player/PlayerCharacter.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "Kismet/KismetMathLibrary.h"
+
+// Sets default values
+AShooterBotController::AShooterBotController()
+{
+    // Steering runs from UBotDirectorSubsystem so its cost shows up in the director's stats
+    PrimaryActorTick.bCanEverTick = false;
+
+    bWantsPlayerState = true;
+
+    // The character aims on its own, don't let its rotation drag the control rotation around
+    bSetControlRotationFromPawnOrientation = false;
+}
+
+void AShooterBotController::OnUnPossess()
+{
+    if (APlayerCharacter* Character = GetPawn<APlayerCharacter>())
+    {
+        Character->ToggleShooting(false);
+    }
+
+    Super::OnUnPossess();
+
+    Target.Reset();
+    bTargetVisible = false;
+    PathPoints.Reset();
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Steering and firing, cheap enough to run every frame
+void AShooterBotController::TickBot(float DeltaTime)
+{
+    APlayerCharacter* Character = GetPawn<APlayerCharacter>();
+    if (!Character)
+    {
+        return;
+    }
+
+    const FVector Location = Character->GetActorLocation();
+    APlayerCharacter* TargetCharacter = Target.Get();
+    const bool bCanSeeTarget = bTargetVisible && TargetCharacter && !TargetCharacter->IsActorBeingDestroyed();
+    const float TargetDistance = TargetCharacter ? FVector::Dist2D(Location, TargetCharacter->GetActorLocation()) : BIG_NUMBER;
+
+    // Follow the path until a visible target is close enough to fight
+    FVector2D MoveInput = FVector2D::ZeroVector;
+    if (!(bCanSeeTarget && TargetDistance <= PreferredRange))
+    {
+        while (PathPoints.IsValidIndex(PathIndex) && FVector::Dist2D(Location, PathPoints[PathIndex]) <= AcceptanceRadius)
+        {
+            ++PathIndex;
+        }
+
+        if (PathPoints.IsValidIndex(PathIndex))
+        {
+            const FVector Direction = (PathPoints[PathIndex] - Location).GetSafeNormal2D();
+            // Move takes (right, forward) relative to the control yaw, which RestartPlayer sets
+            // from the PlayerStart
+            const FVector LocalDirection = FRotator(0.0f, GetControlRotation().Yaw, 0.0f).UnrotateVector(Direction);
+            MoveInput = FVector2D(LocalDirection.Y, LocalDirection.X);
+        }
+    }
+
+    if (!MoveInput.IsNearlyZero())
+    {
+        Character->Move(FInputActionValue(MoveInput));
+    }
+
+    bool bShouldShoot = false;
+    if (bCanSeeTarget)
+    {
+        const FRotator AimRotation(0.0f, UKismetMathLibrary::FindLookAtRotation(Location, TargetCharacter->GetActorLocation()).Yaw, 0.0f);
+        Character->AimAt(AimRotation, DeltaTime);
+
+        const float AimError = FMath::Abs(FRotator::NormalizeAxis(Character->GetActorRotation().Yaw - AimRotation.Yaw));
+        bShouldShoot = TargetDistance <= FireRange && AimError <= AimToleranceDegrees;
+    }
+
+    Character->ToggleShooting(bShouldShoot);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Perception, time sliced by UBotDirectorSubsystem
+void AShooterBotController::UpdatePerception(float Now)
+{
+    NextPerceptionTime = Now + PerceptionInterval;
+
+    APlayerCharacter* Character = GetPawn<APlayerCharacter>();
+    APlayerCharacter* Candidate = Character ? FindNearestEnemy() : nullptr;
+
+    Target = Candidate;
+    if (!Candidate)
+    {
+        bTargetVisible = false;
+        return;
+    }
+
+    if (FVector::Dist(Character->GetActorLocation(), Candidate->GetActorLocation()) > SightRadius)
+    {
+        bTargetVisible = false;
+        return;
+    }
+
+    // Result arrives next frame with the rest of the batched async traces
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(BotSight), false, Character);
+    Params.AddIgnoredActor(Character->CurrentWeapon);
+    FTraceDelegate SightDelegate = FTraceDelegate::CreateUObject(this, &AShooterBotController::OnSightTraceDone, TWeakObjectPtr<APlayerCharacter>(Candidate));
+    GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single,
+        Character->GetPawnViewLocation(),
+        Candidate->GetActorLocation(),
+        ECC_Visibility,
+        Params,
+        FCollisionResponseParams::DefaultResponseParam,
+        &SightDelegate);
+}
+
+void AShooterBotController::OnSightTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum, TWeakObjectPtr<APlayerCharacter> Candidate)
+{
+    if (Target != Candidate)
+    {
+        return;
+    }
+
+    // Hitting the candidate's own weapon still means the candidate is in sight
+    const AActor* HitActor = Datum.OutHits.Num() > 0 ? Datum.OutHits[0].GetActor() : nullptr;
+    bTargetVisible = Candidate.IsValid() && (!HitActor || HitActor->IsOwnedBy(Candidate.Get()));
+}
+
+APlayerCharacter* AShooterBotController::FindNearestEnemy() const
+{
+    const APawn* Self = GetPawn();
+    const FVector Location = Self->GetActorLocation();
+
+    APlayerCharacter* Nearest = nullptr;
+    float NearestDistSq = BIG_NUMBER;
+    for (TActorIterator<APlayerCharacter> It(GetWorld()); It; ++It)
+    {
+        APlayerCharacter* Other = *It;
+        if (Other == Self || Other->IsActorBeingDestroyed())
+        {
+            continue;
+        }
+
+        const float DistSq = FVector::DistSquared(Location, Other->GetActorLocation());
+        if (DistSq < NearestDistSq)
+        {
+            NearestDistSq = DistSq;
+            Nearest = Other;
+        }
+    }
+    return Nearest;
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Pathfinding, requests are throttled by UBotDirectorSubsystem
+bool AShooterBotController::WantsPath(float Now) const
+{
+    const APlayerCharacter* TargetCharacter = Target.Get();
+    if (!GetPawn() || !TargetCharacter || bPathInFlight || Now - LastPathRequestTime < RepathInterval)
+    {
+        return false;
+    }
+
+    if (!PathPoints.IsValidIndex(PathIndex))
+    {
+        return true;
+    }
+
+    return FVector::Dist2D(PathPoints.Last(), TargetCharacter->GetActorLocation()) > RepathDistance;
+}
+
+void AShooterBotController::RequestPath(float Now)
+{
+    LastPathRequestTime = Now;
+
+    UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    const ANavigationData* NavData = NavSys ? NavSys->GetNavDataForProps(GetNavAgentPropertiesRef()) : nullptr;
+    if (!NavData || !Target.IsValid())
+    {
+        return;
+    }
+
+    FPathFindingQuery Query(this, *NavData, GetPawn()->GetNavAgentLocation(), Target->GetActorLocation());
+    Query.SetAllowPartialPaths(true);
+
+    NavSys->FindPathAsync(GetNavAgentPropertiesRef(), Query, FNavPathQueryDelegate::CreateUObject(this, &AShooterBotController::OnPathFound), EPathFindingMode::Regular);
+    bPathInFlight = true;
+}
+
+void AShooterBotController::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+    bPathInFlight = false;
+
+    PathPoints.Reset();
+    PathIndex = 0;
+
+    if (Result == ENavigationQueryResult::Success && Path.IsValid())
+    {
+        for (const FNavPathPoint& Point : Path->GetPathPoints())
+        {
+            PathPoints.Add(Point.Location);
+        }
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,280 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Killcam/KillcamReplay.h"
+#include "Net/ShooterNetTypes.h"
+#include "Camera/CameraComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/ConstructorHelpers.h"
+
+// Sets default values
+AKillcamReplay::AKillcamReplay()
+{
+    PrimaryActorTick.bCanEverTick = true;
+
+    // Only the victim needs the clip
+    bReplicates = true;
+    bOnlyRelevantToOwner = true;
+    SetReplicateMovement(false);
+
+    SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+    RootComponent = SceneRoot;
+
+    Camera = CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"));
+    Camera->SetupAttachment(SceneRoot);
+    Camera->SetRelativeLocation(FVector(0.0f, 0.0f, CameraHeight));
+    Camera->SetRelativeRotation(FRotator(-90.0f, 0.0f, 0.0f));
+
+    ProjectileInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("ProjectileInstances"));
+    ProjectileInstances->SetupAttachment(SceneRoot);
+    ProjectileInstances->SetUsingAbsoluteLocation(true);
+    ProjectileInstances->SetUsingAbsoluteRotation(true);
+    ProjectileInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> SphereMesh(TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+    if (SphereMesh.Succeeded())
+    {
+        ProjectileInstances->SetStaticMesh(SphereMesh.Object);
+    }
+
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> CylinderMesh(TEXT("/Engine/BasicShapes/Cylinder.Cylinder"));
+    if (CylinderMesh.Succeeded())
+    {
+        CharacterMesh = CylinderMesh.Object;
+    }
+}
+
+void AKillcamReplay::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (HasAuthority() && BytesSent < ClipBytes.Num())
+    {
+        TickStreaming(DeltaTime);
+    }
+
+    if (bPlaying)
+    {
+        TickPlayback(DeltaTime);
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Server side streaming
+void AKillcamReplay::StartStreaming(TArray<uint8>&& InClipBytes, int64 InClipBits, float ClipDuration)
+{
+    PlaybackSeconds = ClipDuration + 2.0f;
+
+    // The listen server host has no connection to stream over, play the clip straight away
+    const APlayerController* PC = Cast<APlayerController>(GetOwner());
+    if (PC && PC->IsLocalController())
+    {
+        ReceivedBytes = MoveTemp(InClipBytes);
+        ExpectedBytes = ReceivedBytes.Num();
+        ExpectedBits = InClipBits;
+        StartPlayback();
+        SetLifeSpan(PlaybackSeconds);
+        return;
+    }
+
+    ClipBytes = MoveTemp(InClipBytes);
+    ClipBits = InClipBits;
+    BytesSent = 0;
+    SendAllowance = 0.0f;
+
+    ClientBeginClip(ClipBytes.Num(), ClipBits);
+
+    // Sending can be held back by gameplay traffic, give up if it stalls for too long. Once the
+    // last chunk is out the life span is reset to what the client needs to play the clip
+    const float SendSeconds = static_cast<float>(ClipBytes.Num()) / FMath::Max(BytesPerSecond, 1);
+    SetLifeSpan(SendSeconds * 4.0f + PlaybackSeconds + 5.0f);
+}
+
+void AKillcamReplay::TickStreaming(float DeltaTime)
+{
+    SendAllowance = FMath::Min(SendAllowance + BytesPerSecond * DeltaTime, static_cast<float>(BytesPerSecond));
+
+    // Chunks are reliable RPCs and share the reliable stream with gameplay, actor priority does
+    // not apply to them, so back off while the connection is saturated or chunks are unacked
+    UNetConnection* Connection = GetNetConnection();
+    if (!Connection || !Connection->IsNetReady(false))
+    {
+        return;
+    }
+
+    const UActorChannel* Channel = Connection->FindActorChannelRef(this);
+    int32 Outstanding = Channel ? Channel->NumOutRec : 0;
+
+    while (BytesSent < ClipBytes.Num() && SendAllowance >= 1.0f && Outstanding < MaxOutstandingChunks)
+    {
+        const int32 Size = FMath::Min3(ChunkBytes, ClipBytes.Num() - BytesSent, FMath::FloorToInt32(SendAllowance));
+
+        ClientReceiveChunk(TArray<uint8>(ClipBytes.GetData() + BytesSent, Size));
+
+        BytesSent += Size;
+        SendAllowance -= Size;
+        ++Outstanding;
+    }
+
+    if (BytesSent >= ClipBytes.Num())
+    {
+        ClipBytes.Empty();
+        SetLifeSpan(PlaybackSeconds);
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Client side receive and playback
+void AKillcamReplay::ClientBeginClip_Implementation(int32 TotalBytes, int64 NumBits)
+{
+    ExpectedBytes = TotalBytes;
+    ExpectedBits = NumBits;
+    ReceivedBytes.Reset(TotalBytes);
+}
+
+void AKillcamReplay::ClientReceiveChunk_Implementation(const TArray<uint8>& Chunk)
+{
+    if (ReceivedBytes.Num() + Chunk.Num() > ExpectedBytes)
+    {
+        return;
+    }
+
+    ReceivedBytes.Append(Chunk);
+
+    if (ReceivedBytes.Num() == ExpectedBytes)
+    {
+        StartPlayback();
+    }
+}
+
+void AKillcamReplay::StartPlayback()
+{
+    if (!Killcam::DecodeClip(ReceivedBytes, ExpectedBits, PlaybackFrames, VictimId) || PlaybackFrames.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Received a malformed killcam clip"));
+        return;
+    }
+
+    ReceivedBytes.Empty();
+    PlaybackTime = 0.0f;
+    bPlaying = true;
+
+    if (APlayerController* PC = Cast<APlayerController>(GetOwner()))
+    {
+        PC->SetViewTargetWithBlend(this, 0.25f);
+    }
+}
+
+void AKillcamReplay::TickPlayback(float DeltaTime)
+{
+    PlaybackTime += DeltaTime;
+
+    if (PlaybackTime >= PlaybackFrames.Last().Time)
+    {
+        StopPlayback();
+        return;
+    }
+
+    // Frames are sorted by time, find the pair around PlaybackTime
+    int32 Next = 1;
+    while (Next < PlaybackFrames.Num() - 1 && PlaybackFrames[Next].Time < PlaybackTime)
+    {
+        ++Next;
+    }
+
+    const FKillcamFrame& From = PlaybackFrames[Next - 1];
+    const FKillcamFrame& To = PlaybackFrames[Next];
+    const float Alpha = FMath::Clamp((PlaybackTime - From.Time) / FMath::Max(To.Time - From.Time, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+
+    for (TPair<uint8, UStaticMeshComponent*>& Proxy : CharacterProxies)
+    {
+        Proxy.Value->SetVisibility(false);
+    }
+
+    for (int32 Index = 0; Index < From.NumCharacters; ++Index)
+    {
+        const FKillcamCharacterSample& FromSample = From.Characters[Index];
+        const FKillcamCharacterSample* ToSample = To.FindCharacter(FromSample.Id);
+        if (!ToSample)
+        {
+            ToSample = &FromSample;
+        }
+
+        const FVector Location = FMath::Lerp(FVector(FromSample.X, FromSample.Y, FromSample.Z), FVector(ToSample->X, ToSample->Y, ToSample->Z), Alpha);
+        const FRotator Rotation = FMath::Lerp(FRotator(0.0f, ShooterNet::DecompressYaw(FromSample.Yaw), 0.0f), FRotator(0.0f, ShooterNet::DecompressYaw(ToSample->Yaw), 0.0f), Alpha);
+
+        UStaticMeshComponent*& Proxy = CharacterProxies.FindOrAdd(FromSample.Id);
+        if (!Proxy)
+        {
+            Proxy = NewObject<UStaticMeshComponent>(this);
+            Proxy->SetStaticMesh(CharacterMesh);
+            Proxy->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+            Proxy->SetUsingAbsoluteLocation(true);
+            Proxy->SetUsingAbsoluteRotation(true);
+            Proxy->RegisterComponent();
+        }
+
+        Proxy->SetWorldLocationAndRotation(Location, Rotation);
+        Proxy->SetVisibility(true);
+
+        if (FromSample.Id == VictimId)
+        {
+            SetActorLocation(Location);
+        }
+    }
+
+    // Projectiles fly in a straight line from their spawn sample
+    ProjectileInstances->ClearInstances();
+    for (const FKillcamFrame& Frame : PlaybackFrames)
+    {
+        const float Age = PlaybackTime - Frame.Time;
+        if (Age < 0.0f)
+        {
+            break;
+        }
+
+        if (Age > ProjectileLifetime)
+        {
+            continue;
+        }
+
+        for (int32 Index = 0; Index < Frame.NumProjectiles; ++Index)
+        {
+            const FKillcamProjectileSample& Sample = Frame.Projectiles[Index];
+            const FVector Direction = FRotator(0.0f, ShooterNet::DecompressYaw(Sample.Yaw), 0.0f).Vector();
+            const float Speed = ShooterNet::ProjectileSpeedTable[FMath::Min<uint32>(Sample.SpeedIndex, UE_ARRAY_COUNT(ShooterNet::ProjectileSpeedTable) - 1)];
+            const FVector Location = FVector(Sample.X, Sample.Y, Sample.Z) + Direction * Speed * Age;
+
+            ProjectileInstances->AddInstance(FTransform(FRotator::ZeroRotator, Location, FVector(0.2f)), true);
+        }
+    }
+}
+
+void AKillcamReplay::StopPlayback()
+{
+    bPlaying = false;
+    PlaybackFrames.Empty();
+    ProjectileInstances->ClearInstances();
+
+    for (TPair<uint8, UStaticMeshComponent*>& Proxy : CharacterProxies)
+    {
+        Proxy.Value->DestroyComponent();
+    }
+    CharacterProxies.Empty();
+
+    if (APlayerController* PC = Cast<APlayerController>(GetOwner()))
+    {
+        if (PC->GetViewTarget() == this)
+        {
+            PC->SetViewTargetWithBlend(PC->GetPawn() ? static_cast<AActor*>(PC->GetPawn()) : PC, 0.25f);
+        }
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Killcam/KillcamSubsystem.h"
+#include "Killcam/KillcamReplay.h"
+#include "Shoot_N_Run.h"
+#include "Player/PlayerCharacter.h"
+#include "Net/ShooterNetTypes.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_MEMORY_STAT(TEXT("Killcam Buffer Memory"), STAT_KillcamBufferMemory, STATGROUP_ShootNRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Killcam Buffered Frames"), STAT_KillcamBufferedFrames, STATGROUP_ShootNRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Killcam Last Clip Bytes"), STAT_KillcamLastClipBytes, STATGROUP_ShootNRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Killcam Dropped Projectiles"), STAT_KillcamDroppedProjectiles, STATGROUP_ShootNRun);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool UKillcamSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UKillcamSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    SampleRate = FMath::Max(SampleRate, 1.0f);
+}
+
+void UKillcamSubsystem::Deinitialize()
+{
+    DEC_MEMORY_STAT_BY(STAT_KillcamBufferMemory, Frames.GetAllocatedSize());
+    Frames.Empty();
+
+    Super::Deinitialize();
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void UKillcamSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    const ENetMode NetMode = GetWorld()->GetNetMode();
+    if (NetMode != NM_DedicatedServer && NetMode != NM_ListenServer)
+    {
+        return;
+    }
+
+    // Allocated once, the buffer never grows past the budget afterwards
+    if (Frames.Num() == 0)
+    {
+        const int32 NumFrames = FMath::Max(1, MemoryBudgetKB * 1024 / static_cast<int32>(sizeof(FKillcamFrame)));
+        Frames.SetNumZeroed(NumFrames);
+        Frames.Shrink();
+        INC_MEMORY_STAT_BY(STAT_KillcamBufferMemory, Frames.GetAllocatedSize());
+    }
+
+    TimeSinceLastSample += DeltaTime;
+    if (TimeSinceLastSample >= 1.0f / SampleRate)
+    {
+        TimeSinceLastSample = 0.0f;
+        RecordFrame(GetWorld()->GetTimeSeconds());
+    }
+}
+
+void UKillcamSubsystem::RecordFrame(float Time)
+{
+    const int32 Capacity = Frames.Num();
+    const int32 Index = (Head + Count) % Capacity;
+
+    if (Count < Capacity)
+    {
+        ++Count;
+    }
+    else
+    {
+        Head = (Head + 1) % Capacity;
+    }
+
+    ++NumRecordedFrames;
+    PruneCharacterIds();
+
+    FKillcamFrame& Frame = Frames[Index];
+    Frame = PendingProjectiles;
+    Frame.Time = Time;
+    Frame.NumCharacters = 0;
+    PendingProjectiles.NumProjectiles = 0;
+
+    for (TActorIterator<APlayerCharacter> It(GetWorld()); It; ++It)
+    {
+        APlayerCharacter* Character = *It;
+
+        uint8 Id = 0;
+        if (GetCharacterId(Character, Id))
+        {
+            Frame.AddCharacter(Id, Character->GetActorLocation(), Character->GetActorRotation().Yaw);
+        }
+    }
+
+    SET_DWORD_STAT(STAT_KillcamBufferedFrames, Count);
+}
+
+void UKillcamSubsystem::RecordProjectileSpawn(const FProjectileSpawnState& SpawnState)
+{
+    if (!PendingProjectiles.AddProjectile(SpawnState))
+    {
+        INC_DWORD_STAT(STAT_KillcamDroppedProjectiles);
+    }
+}
+
+bool UKillcamSubsystem::GetCharacterId(const APlayerCharacter* Character, uint8& OutId)
+{
+    if (const uint8* Id = CharacterIds.Find(Character))
+    {
+        OutId = *Id;
+        return true;
+    }
+
+    if (FreedCharacterIds.Num() > 0 && NumRecordedFrames - FreedCharacterIds[0].Value >= Frames.Num())
+    {
+        OutId = FreedCharacterIds[0].Key;
+        FreedCharacterIds.RemoveAt(0, 1, false);
+    }
+    else if (NextCharacterId <= MAX_uint8)
+    {
+        OutId = static_cast<uint8>(NextCharacterId++);
+    }
+    else
+    {
+        return false;
+    }
+
+    CharacterIds.Add(Character, OutId);
+    return true;
+}
+
+// Killed, kicked and removed bot characters all end up here once their actor is gone
+void UKillcamSubsystem::PruneCharacterIds()
+{
+    for (auto It = CharacterIds.CreateIterator(); It; ++It)
+    {
+        if (!IsValid(It.Key().ResolveObjectPtr()))
+        {
+            FreedCharacterIds.Emplace(It.Value(), NumRecordedFrames);
+            It.RemoveCurrent();
+        }
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void UKillcamSubsystem::SendKillcam(APlayerCharacter* Victim)
+{
+    // Several projectiles can overlap the victim in the same frame, only the first sends a clip
+    if (!Victim || Victim->IsActorBeingDestroyed())
+    {
+        return;
+    }
+
+    APlayerController* PC = Cast<APlayerController>(Victim->GetController());
+    if (!PC || Count == 0)
+    {
+        return;
+    }
+
+    const int32 NumClipFrames = FMath::Min(Count, FMath::CeilToInt32(ClipSeconds * SampleRate));
+
+    TArray<const FKillcamFrame*> ClipFrames;
+    ClipFrames.Reserve(NumClipFrames);
+    for (int32 Offset = Count - NumClipFrames; Offset < Count; ++Offset)
+    {
+        ClipFrames.Add(&Frames[(Head + Offset) % Frames.Num()]);
+    }
+
+    uint8 VictimId = 0;
+    if (!GetCharacterId(Victim, VictimId))
+    {
+        return;
+    }
+
+    TArray<uint8> ClipBytes;
+    int64 ClipBits = 0;
+    Killcam::EncodeClip(ClipFrames, VictimId, ClipBytes, ClipBits);
+    const float ClipDuration = ClipFrames.Last()->Time - ClipFrames[0]->Time;
+
+    SET_DWORD_STAT(STAT_KillcamLastClipBytes, ClipBytes.Num());
+
+    UClass* Class = ReplayClass.IsNull() ? AKillcamReplay::StaticClass() : ReplayClass.LoadSynchronous();
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Owner = PC;
+    AKillcamReplay* Replay = GetWorld()->SpawnActor<AKillcamReplay>(Class, Victim->GetActorTransform(), SpawnParams);
+    if (Replay)
+    {
+        Replay->StartStreaming(MoveTemp(ClipBytes), ClipBits, ClipDuration);
+    }
+}
+
+TStatId UKillcamSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UKillcamSubsystem, STATGROUP_Tickables);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Killcam/KillcamTypes.h"
+#include "Net/ShooterNetTypes.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+namespace
+{
+    uint32 ZigZag(int32 Value)
+    {
+        return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+    }
+
+    int32 UnZigZag(uint32 Value)
+    {
+        return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+    }
+
+    void WriteSigned(FBitWriter& Writer, int32 Value)
+    {
+        uint32 Packed = ZigZag(Value);
+        Writer.SerializeIntPacked(Packed);
+    }
+
+    int32 ReadSigned(FBitReader& Reader)
+    {
+        uint32 Packed = 0;
+        Reader.SerializeIntPacked(Packed);
+        return UnZigZag(Packed);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void FKillcamFrame::AddCharacter(uint8 Id, const FVector& Location, float Yaw)
+{
+    if (NumCharacters >= Killcam::MaxCharacters)
+    {
+        return;
+    }
+
+    FKillcamCharacterSample& Sample = Characters[NumCharacters++];
+    Sample.X = FMath::RoundToInt32(Location.X);
+    Sample.Y = FMath::RoundToInt32(Location.Y);
+    Sample.Z = static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(Location.Z), MIN_int16, MAX_int16));
+    Sample.Yaw = ShooterNet::CompressYaw(Yaw);
+    Sample.Id = Id;
+}
+
+bool FKillcamFrame::AddProjectile(const FProjectileSpawnState& SpawnState)
+{
+    if (NumProjectiles >= Killcam::MaxProjectilesPerFrame)
+    {
+        return false;
+    }
+
+    FKillcamProjectileSample& Sample = Projectiles[NumProjectiles++];
+    Sample.X = FMath::RoundToInt32(SpawnState.Origin.X);
+    Sample.Y = FMath::RoundToInt32(SpawnState.Origin.Y);
+    Sample.Z = static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(SpawnState.Origin.Z), MIN_int16, MAX_int16));
+    Sample.Yaw = ShooterNet::CompressYaw(SpawnState.Yaw);
+    Sample.SpeedIndex = SpawnState.SpeedIndex;
+    return true;
+}
+
+const FKillcamCharacterSample* FKillcamFrame::FindCharacter(uint8 Id) const
+{
+    for (int32 Index = 0; Index < NumCharacters; ++Index)
+    {
+        if (Characters[Index].Id == Id)
+        {
+            return &Characters[Index];
+        }
+    }
+    return nullptr;
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Clip layout: victim id, frame count, then per frame a time delta in ms, the characters
+// (absolute the first time an id shows up, otherwise a delta to its previous sample)
+// and the projectile spawns (absolute)
+void Killcam::EncodeClip(const TArray<const FKillcamFrame*>& Frames, uint8 VictimId, TArray<uint8>& OutBytes, int64& OutNumBits)
+{
+    FBitWriter Writer(0, true);
+
+    Writer << VictimId;
+
+    uint32 NumFrames = Frames.Num();
+    Writer.SerializeIntPacked(NumFrames);
+
+    const FKillcamFrame* Previous = nullptr;
+    for (const FKillcamFrame* Frame : Frames)
+    {
+        uint32 TimeDeltaMs = Previous ? FMath::Max(0, FMath::RoundToInt32((Frame->Time - Previous->Time) * 1000.0f)) : 0;
+        Writer.SerializeIntPacked(TimeDeltaMs);
+
+        uint32 NumCharacters = Frame->NumCharacters;
+        Writer.SerializeInt(NumCharacters, Killcam::MaxCharacters + 1);
+
+        for (int32 Index = 0; Index < Frame->NumCharacters; ++Index)
+        {
+            FKillcamCharacterSample Sample = Frame->Characters[Index];
+            Writer << Sample.Id;
+
+            const FKillcamCharacterSample* Base = Previous ? Previous->FindCharacter(Sample.Id) : nullptr;
+            const FKillcamCharacterSample Zero;
+            if (!Base)
+            {
+                Base = &Zero;
+            }
+
+            WriteSigned(Writer, Sample.X - Base->X);
+            WriteSigned(Writer, Sample.Y - Base->Y);
+            WriteSigned(Writer, Sample.Z - Base->Z);
+            WriteSigned(Writer, static_cast<int16>(Sample.Yaw - Base->Yaw));
+        }
+
+        uint32 NumProjectiles = Frame->NumProjectiles;
+        Writer.SerializeInt(NumProjectiles, Killcam::MaxProjectilesPerFrame + 1);
+
+        for (int32 Index = 0; Index < Frame->NumProjectiles; ++Index)
+        {
+            FKillcamProjectileSample Sample = Frame->Projectiles[Index];
+            WriteSigned(Writer, Sample.X);
+            WriteSigned(Writer, Sample.Y);
+            WriteSigned(Writer, Sample.Z);
+            Writer << Sample.Yaw;
+            Writer.SerializeBits(&Sample.SpeedIndex, ShooterNet::ProjectileSpeedIndexBits);
+        }
+
+        Previous = Frame;
+    }
+
+    OutNumBits = Writer.GetNumBits();
+    OutBytes = MoveTemp(*Writer.GetBuffer());
+    OutBytes.SetNum(Writer.GetNumBytes());
+}
+
+bool Killcam::DecodeClip(const TArray<uint8>& Bytes, int64 NumBits, TArray<FKillcamFrame>& OutFrames, uint8& OutVictimId)
+{
+    if (NumBits > Bytes.Num() * 8)
+    {
+        return false;
+    }
+
+    FBitReader Reader(const_cast<uint8*>(Bytes.GetData()), NumBits);
+
+    Reader << OutVictimId;
+
+    uint32 NumFrames = 0;
+    Reader.SerializeIntPacked(NumFrames);
+
+    // Every frame costs at least a few bits, anything larger is garbage
+    if (Reader.IsError() || NumFrames > static_cast<uint32>(NumBits))
+    {
+        return false;
+    }
+
+    OutFrames.Reset(NumFrames);
+
+    float Time = 0.0f;
+    for (uint32 FrameIndex = 0; FrameIndex < NumFrames && !Reader.IsError(); ++FrameIndex)
+    {
+        const FKillcamFrame* Previous = OutFrames.Num() > 0 ? &OutFrames.Last() : nullptr;
+        FKillcamFrame Frame;
+
+        uint32 TimeDeltaMs = 0;
+        Reader.SerializeIntPacked(TimeDeltaMs);
+        Time += TimeDeltaMs / 1000.0f;
+        Frame.Time = Time;
+
+        uint32 NumCharacters = 0;
+        Reader.SerializeInt(NumCharacters, Killcam::MaxCharacters + 1);
+        Frame.NumCharacters = static_cast<uint8>(NumCharacters);
+
+        for (uint32 Index = 0; Index < NumCharacters; ++Index)
+        {
+            FKillcamCharacterSample& Sample = Frame.Characters[Index];
+            Reader << Sample.Id;
+
+            const FKillcamCharacterSample* Base = Previous ? Previous->FindCharacter(Sample.Id) : nullptr;
+            const FKillcamCharacterSample Zero;
+            if (!Base)
+            {
+                Base = &Zero;
+            }
+
+            Sample.X = Base->X + ReadSigned(Reader);
+            Sample.Y = Base->Y + ReadSigned(Reader);
+            Sample.Z = static_cast<int16>(Base->Z + ReadSigned(Reader));
+            Sample.Yaw = static_cast<uint16>(Base->Yaw + ReadSigned(Reader));
+        }
+
+        uint32 NumProjectiles = 0;
+        Reader.SerializeInt(NumProjectiles, Killcam::MaxProjectilesPerFrame + 1);
+        Frame.NumProjectiles = static_cast<uint8>(NumProjectiles);
+
+        for (uint32 Index = 0; Index < NumProjectiles; ++Index)
+        {
+            FKillcamProjectileSample& Sample = Frame.Projectiles[Index];
+            Sample.X = ReadSigned(Reader);
+            Sample.Y = ReadSigned(Reader);
+            Sample.Z = static_cast<int16>(ReadSigned(Reader));
+            Reader << Sample.Yaw;
+            Reader.SerializeBits(&Sample.SpeedIndex, ShooterNet::ProjectileSpeedIndexBits);
+        }
+
+        OutFrames.Add(Frame);
+    }
+
+    return !Reader.IsError();
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,390 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/NetSoakSubsystem.h"
+#include "Net/ShooterNetBenchmarkSubsystem.h"
+#include "Net/RpcGuardSubsystem.h"
+#include "Player/PlayerCharacter.h"
+#include "Net/ShooterNetTypes.h"
+#include "Engine/Channel.h"
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void FNetSoakHistogram::Add(float Value)
+{
+    const int32 Bin = FMath::Clamp(FMath::FloorToInt32(Value / BinSize), 0, Bins.Num() - 1);
+    ++Bins[Bin];
+    ++Count;
+    Max = FMath::Max(Max, Value);
+}
+
+float FNetSoakHistogram::Percentile(float Fraction) const
+{
+    const uint32 Target = FMath::CeilToInt32(Count * Fraction);
+    uint32 Seen = 0;
+    for (int32 Bin = 0; Bin < Bins.Num(); ++Bin)
+    {
+        Seen += Bins[Bin];
+        if (Seen >= Target && Seen > 0)
+        {
+            return (Bin + 1) * BinSize;
+        }
+    }
+    return 0.0f;
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+UNetSoakSubsystem::UNetSoakSubsystem()
+    : AimDivergence(1.0f, 181)
+    , FireToHitMs(5.0f, 400)
+    , ServerFrameMs(0.5f, 400)
+{
+}
+
+bool UNetSoakSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && FParse::Param(FCommandLine::Get(), TEXT("NetSoak")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UNetSoakSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    FParse::Value(FCommandLine::Get(), TEXT("NetSoakDuration="), Duration);
+    FParse::Value(FCommandLine::Get(), TEXT("NetSoakFlood="), FloodRpcsPerFrame);
+
+    FString ProfileName;
+    FParse::Value(FCommandLine::Get(), TEXT("NetSoakProfile="), ProfileName);
+
+    const FNetSoakProfile* Found = Profiles.FindByPredicate([&ProfileName](const FNetSoakProfile& Candidate)
+    {
+        return Candidate.Name == FName(*ProfileName);
+    });
+
+    if (Found)
+    {
+        Profile = *Found;
+    }
+    else
+    {
+        UE_LOG(LogShooterNet, Warning, TEXT("Net soak profile '%s' not found, running without impairment"), *ProfileName);
+        Profile.Name = TEXT("None");
+    }
+
+    ApplyProfile();
+}
+
+void UNetSoakSubsystem::ApplyProfile()
+{
+#if DO_ENABLE_NET_TEST
+    if (UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+    {
+        FPacketSimulationSettings Settings;
+        Settings.PktLag = Profile.PktLag;
+        Settings.PktLagVariance = Profile.PktLagVariance;
+        Settings.PktLoss = Profile.PktLoss;
+        Settings.PktDup = Profile.PktDup;
+        NetDriver->SetPacketSimulationSettings(Settings);
+
+        UE_LOG(LogShooterNet, Log, TEXT("Net soak profile %s: PktLag=%d PktLagVariance=%d PktLoss=%d PktDup=%d"),
+            *Profile.Name.ToString(), Profile.PktLag, Profile.PktLagVariance, Profile.PktLoss, Profile.PktDup);
+    }
+#else
+    UE_LOG(LogShooterNet, Warning, TEXT("Packet simulation is compiled out of this build, net soak runs unimpaired"));
+#endif
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void UNetSoakSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (bFinished)
+    {
+        return;
+    }
+
+    Elapsed += DeltaTime;
+
+    if (GetWorld()->GetNetMode() == NM_Client)
+    {
+        TickClient(DeltaTime);
+    }
+    else
+    {
+        TickServer(DeltaTime);
+    }
+
+    if (Elapsed >= Duration)
+    {
+        FinishSoak();
+    }
+}
+
+void UNetSoakSubsystem::TickServer(float DeltaTime)
+{
+    UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+    if (!NetDriver)
+    {
+        return;
+    }
+
+    PeakClients = FMath::Max(PeakClients, NetDriver->ClientConnections.Num());
+
+    // The previous frame's work, the time spent sleeping to hold the tick rate is not load
+    ServerFrameMs.Add(static_cast<float>((FApp::GetDeltaTime() - FApp::GetIdleTime()) * 1000.0));
+
+    for (auto It = AcceptedAims.CreateIterator(); It; ++It)
+    {
+        if (!It.Key().ResolveObjectPtr())
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    for (UNetConnection* Connection : NetDriver->ClientConnections)
+    {
+        int32 MaxOutstanding = 0;
+        for (UChannel* Channel : Connection->OpenChannels)
+        {
+            if (Channel)
+            {
+                MaxOutstanding = FMath::Max(MaxOutstanding, Channel->NumOutRec);
+            }
+        }
+        PeakReliableOccupancy = FMath::Max(PeakReliableOccupancy, static_cast<float>(MaxOutstanding) / RELIABLE_BUFFER);
+
+        // Same test as UNetConnection::IsNetReady, counted on the ready -> saturated edge
+        const bool bSaturated = Connection->QueuedBits + Connection->SendBuffer.GetNumBits() > 0;
+        bool& bWasSaturated = SaturatedConnections.FindOrAdd(Connection);
+        if (bSaturated && !bWasSaturated)
+        {
+            ++NumSaturationEvents;
+        }
+        bWasSaturated = bSaturated;
+    }
+
+    RespawnPlayers();
+}
+
+void UNetSoakSubsystem::RespawnPlayers()
+{
+    AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+    if (!GameMode)
+    {
+        return;
+    }
+
+    for (auto It = PawnlessSince.CreateIterator(); It; ++It)
+    {
+        if (!It.Key().ResolveObjectPtr())
+        {
+            It.RemoveCurrent();
+        }
+    }
+
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        APlayerController* PC = It->Get();
+        if (!PC)
+        {
+            continue;
+        }
+
+        if (PC->GetPawn())
+        {
+            PawnlessSince.Remove(PC);
+            continue;
+        }
+
+        const float DiedAt = PawnlessSince.FindOrAdd(PC, Elapsed);
+        if (Elapsed - DiedAt >= RespawnDelay && GameMode->PlayerCanRestart(PC))
+        {
+            GameMode->RestartPlayer(PC);
+            PawnlessSince.Remove(PC);
+        }
+    }
+}
+
+void UNetSoakSubsystem::TickClient(float DeltaTime)
+{
+    APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    APlayerCharacter* Character = PC ? Cast<APlayerCharacter>(PC->GetPawn()) : nullptr;
+    if (!Character)
+    {
+        return;
+    }
+
+    // Change direction, aim, trigger and sprint every second or two, like a restless player
+    TimeToNextDriveChange -= DeltaTime;
+    if (TimeToNextDriveChange <= 0.0f)
+    {
+        TimeToNextDriveChange = FMath::FRandRange(0.5f, 2.0f);
+        DriveInput = FVector2D(FMath::FRandRange(-1.0f, 1.0f), FMath::FRandRange(-1.0f, 1.0f));
+        DriveTargetYaw = FMath::FRandRange(-180.0f, 180.0f);
+        Character->ToggleShooting(FMath::RandBool());
+        Character->SetSprinting(FMath::RandBool());
+    }
+
+    // Sweep towards the new aim like a mouse would instead of snapping to it
+    DriveYaw = FMath::FixedTurn(DriveYaw, DriveTargetYaw, DriveTurnRate * DeltaTime);
+
+    if (FloodRpcsPerFrame > 0)
+    {
+        Character->FloodServerRpcs(FloodRpcsPerFrame);
+    }
+
+    Character->AddMovementInput(FVector(DriveInput.X, DriveInput.Y, 0.0f));
+    Character->AimAt(FRotator(0.0f, DriveYaw + FMath::Sin(Elapsed * 2.0f) * 30.0f, 0.0f), DeltaTime);
+
+    TimeToNextAimReport -= DeltaTime;
+    if (TimeToNextAimReport <= 0.0f)
+    {
+        TimeToNextAimReport = AimReportInterval;
+        Character->ReportPredictedAim();
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void UNetSoakSubsystem::RecordCorrection()
+{
+    ++NumCorrections;
+}
+
+void UNetSoakSubsystem::RecordAcceptedAim(APlayerCharacter* Character, float Yaw)
+{
+    AGameStateBase* GameState = GetWorld()->GetGameState();
+    const float ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+    TArray<FAcceptedAim>& History = AcceptedAims.FindOrAdd(Character);
+    if (History.Num() >= MaxAcceptedAims)
+    {
+        History.RemoveAt(0, 1, false);
+    }
+    History.Add({ ServerTime, Yaw });
+}
+
+// Compare against the aim the server was using at the instant the client sampled its prediction
+void UNetSoakSubsystem::RecordPredictedAim(APlayerCharacter* Character, float ServerTime, float PredictedYaw)
+{
+    const TArray<FAcceptedAim>* History = AcceptedAims.Find(Character);
+    if (!History)
+    {
+        return;
+    }
+
+    for (int32 Index = History->Num() - 1; Index >= 0; --Index)
+    {
+        const FAcceptedAim& Accepted = (*History)[Index];
+        if (Accepted.ServerTime <= ServerTime)
+        {
+            AimDivergence.Add(FMath::Abs(FRotator::NormalizeAxis(PredictedYaw - Accepted.Yaw)));
+            return;
+        }
+    }
+}
+
+void UNetSoakSubsystem::RecordHit(float FireInputTime)
+{
+    // FireInputTime is on the same clock, the client stamps its press with its server world time
+    AGameStateBase* GameState = GetWorld()->GetGameState();
+    const float ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+    FireToHitMs.Add(FMath::Max(0.0f, ServerTime - FireInputTime) * 1000.0f);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void UNetSoakSubsystem::FinishSoak()
+{
+    bFinished = true;
+
+    if (GetWorld()->GetNetMode() == NM_Client)
+    {
+        FPlatformMisc::RequestExitWithStatus(false, 0);
+        return;
+    }
+
+    const float Minutes = FMath::Max(Elapsed / 60.0f, KINDA_SMALL_NUMBER);
+    const float CorrectionsPerMinute = NumCorrections / Minutes;
+    const float AimP95 = AimDivergence.Percentile(0.95f);
+    const float FireToHitP95 = FireToHitMs.Percentile(0.95f);
+
+    const URpcGuardSubsystem* RpcGuard = GetWorld()->GetSubsystem<URpcGuardSubsystem>();
+    const double RpcGuardPeakMs = RpcGuard ? RpcGuard->GetPeakFrameMs() : 0.0;
+    const float ServerFrameP95 = ServerFrameMs.Percentile(0.95f);
+
+    TArray<FString> Failures;
+    if (CorrectionsPerMinute > MaxCorrectionsPerMinute)
+    {
+        Failures.Add(FString::Printf(TEXT("corrections/min %.1f > %.1f"), CorrectionsPerMinute, MaxCorrectionsPerMinute));
+    }
+    if (PeakReliableOccupancy > MaxReliableBufferOccupancy)
+    {
+        Failures.Add(FString::Printf(TEXT("reliable buffer occupancy %.2f > %.2f"), PeakReliableOccupancy, MaxReliableBufferOccupancy));
+    }
+    if (NumSaturationEvents > MaxSaturationEvents)
+    {
+        Failures.Add(FString::Printf(TEXT("saturation events %d > %d"), NumSaturationEvents, MaxSaturationEvents));
+    }
+    if (AimP95 > MaxAimDivergenceP95)
+    {
+        Failures.Add(FString::Printf(TEXT("aim divergence p95 %.1f > %.1f deg"), AimP95, MaxAimDivergenceP95));
+    }
+    if (FireToHitP95 > MaxFireToHitP95Ms)
+    {
+        Failures.Add(FString::Printf(TEXT("fire-to-hit p95 %.0f > %.0f ms"), FireToHitP95, MaxFireToHitP95Ms));
+    }
+    if (ServerFrameP95 > MaxServerFrameP95Ms)
+    {
+        Failures.Add(FString::Printf(TEXT("server frame p95 %.1f > %.1f ms"), ServerFrameP95, MaxServerFrameP95Ms));
+    }
+    if (ServerFrameMs.Max > MaxServerFramePeakMs)
+    {
+        Failures.Add(FString::Printf(TEXT("server frame peak %.1f > %.1f ms"), ServerFrameMs.Max, MaxServerFramePeakMs));
+    }
+
+    FString Report;
+    Report += FString::Printf(TEXT("Profile: %s (PktLag=%d PktLagVariance=%d PktLoss=%d PktDup=%d)\n"),
+        *Profile.Name.ToString(), Profile.PktLag, Profile.PktLagVariance, Profile.PktLoss, Profile.PktDup);
+    Report += FString::Printf(TEXT("Duration: %.0f s, peak clients: %d\n"), Elapsed, PeakClients);
+    Report += FString::Printf(TEXT("Movement corrections: %d (%.1f/min)\n"), NumCorrections, CorrectionsPerMinute);
+    Report += FString::Printf(TEXT("Peak reliable buffer occupancy: %.2f\n"), PeakReliableOccupancy);
+    Report += FString::Printf(TEXT("Saturation events: %d\n"), NumSaturationEvents);
+    Report += FString::Printf(TEXT("Aim divergence: samples=%u p50=%.1f p95=%.1f max=%.1f deg\n"),
+        AimDivergence.Count, AimDivergence.Percentile(0.5f), AimP95, AimDivergence.Max);
+    Report += FString::Printf(TEXT("Fire-to-hit: samples=%u p50=%.0f p95=%.0f max=%.0f ms\n"),
+        FireToHitMs.Count, FireToHitMs.Percentile(0.5f), FireToHitP95, FireToHitMs.Max);
+    Report += FString::Printf(TEXT("Server frame: p50=%.1f p95=%.1f max=%.1f ms, flood=%d rpcs/frame per client\n"),
+        ServerFrameMs.Percentile(0.5f), ServerFrameP95, ServerFrameMs.Max, FloodRpcsPerFrame);
+    Report += FString::Printf(TEXT("Rpc guard: throttled=%d kicked=%d peak=%.3f ms/frame\n"),
+        RpcGuard ? RpcGuard->GetNumThrottled() : 0, RpcGuard ? RpcGuard->GetNumKicked() : 0, RpcGuardPeakMs);
+    Report += Failures.Num() == 0 ? TEXT("Result: PASS\n") : FString::Printf(TEXT("Result: FAIL (%s)\n"), *FString::Join(Failures, TEXT(", ")));
+
+    const FString ReportPath = FPaths::ProjectSavedDir() / TEXT("NetSoak") / (Profile.Name.ToString() + TEXT(".txt"));
+    FFileHelper::SaveStringToFile(Report, *ReportPath);
+
+    UE_LOG(LogShooterNet, Display, TEXT("Net soak report written to %s\n%s"), *ReportPath, *Report);
+
+    FPlatformMisc::RequestExitWithStatus(false, Failures.Num() == 0 ? 0 : 1);
+}
+
+TStatId UNetSoakSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UNetSoakSubsystem, STATGROUP_Tickables);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
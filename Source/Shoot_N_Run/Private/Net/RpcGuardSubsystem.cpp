@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/RpcGuardSubsystem.h"
+#include "Net/ShooterNetBenchmarkSubsystem.h"
+#include "Shoot_N_Run.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/GameSession.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rpc Guard"), STAT_RpcGuard, STATGROUP_ShootNRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rpcs Checked"), STAT_RpcsChecked, STATGROUP_ShootNRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rpcs Throttled"), STAT_RpcsThrottled, STATGROUP_ShootNRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rpcs Rejected"), STAT_RpcsRejected, STATGROUP_ShootNRun);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rpc Kicks"), STAT_RpcKicks, STATGROUP_ShootNRun);
+
+bool RpcValidation::Check(bool bValid)
+{
+    if (!bValid)
+    {
+        INC_DWORD_STAT(STAT_RpcsRejected);
+    }
+    return bValid;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool URpcGuardSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void URpcGuardSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    PeakFrameMs = FMath::Max(PeakFrameMs, FPlatformTime::ToMilliseconds64(CyclesThisFrame));
+    CyclesThisFrame = 0;
+
+    // Drop budgets of connections that went away
+    TimeSincePrune += DeltaTime;
+    if (TimeSincePrune >= 10.0f)
+    {
+        TimeSincePrune = 0.0f;
+        for (auto It = Budgets.CreateIterator(); It; ++It)
+        {
+            if (!It.Key().ResolveObjectPtr())
+            {
+                It.RemoveCurrent();
+            }
+        }
+    }
+}
+
+TStatId URpcGuardSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(URpcGuardSubsystem, STATGROUP_Tickables);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool URpcGuardSubsystem::AllowRpc(const AActor* Caller, ERpcKind Kind, float Cost)
+{
+    // Locally controlled on the server, nothing came over the wire
+    UNetConnection* Connection = Caller ? Caller->GetNetConnection() : nullptr;
+    if (!Connection)
+    {
+        return true;
+    }
+
+    URpcGuardSubsystem* Guard = Caller->GetWorld()->GetSubsystem<URpcGuardSubsystem>();
+    return !Guard || Guard->Consume(Connection, Kind, Cost);
+}
+
+bool URpcGuardSubsystem::Consume(UNetConnection* Connection, ERpcKind Kind, float Cost)
+{
+    SCOPE_CYCLE_COUNTER(STAT_RpcGuard);
+    const uint32 StartCycles = FPlatformTime::Cycles();
+
+    INC_DWORD_STAT(STAT_RpcsChecked);
+
+    FConnectionBudget& Budget = Budgets.FindOrAdd(Connection);
+    if (Budget.bKicked)
+    {
+        CyclesThisFrame += FPlatformTime::Cycles() - StartCycles;
+        return false;
+    }
+
+    const FRpcRateLimit& Limit = GetLimit(Kind);
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    FTokenBucket& Bucket = Budget.Buckets[static_cast<uint8>(Kind)];
+    if (Bucket.Tokens < 0.0f)
+    {
+        Bucket.Tokens = Limit.Burst;
+    }
+    else
+    {
+        Bucket.Tokens = FMath::Min(Limit.Burst, Bucket.Tokens + static_cast<float>(Now - Bucket.LastRefillTime) * Limit.RatePerSecond);
+    }
+    Bucket.LastRefillTime = Now;
+
+    bool bAllowed = true;
+    if (Bucket.Tokens >= Cost)
+    {
+        Bucket.Tokens -= Cost;
+    }
+    else
+    {
+        bAllowed = false;
+        ++NumThrottled;
+        INC_DWORD_STAT(STAT_RpcsThrottled);
+
+        Budget.Violations = FMath::Max(0.0f, Budget.Violations - static_cast<float>(Now - Budget.LastViolationTime) * ViolationDecayPerSecond) + 1.0f;
+        Budget.LastViolationTime = Now;
+
+        if (Budget.Violations >= KickViolations)
+        {
+            Budget.bKicked = true;
+            Kick(Connection);
+        }
+    }
+
+    CyclesThisFrame += FPlatformTime::Cycles() - StartCycles;
+    return bAllowed;
+}
+
+const FRpcRateLimit& URpcGuardSubsystem::GetLimit(ERpcKind Kind) const
+{
+    switch (Kind)
+    {
+    case ERpcKind::Shoot:
+        return ShootLimit;
+    case ERpcKind::Sprint:
+        return SprintLimit;
+    case ERpcKind::Rotate:
+        return RotateLimit;
+    case ERpcKind::AimTurn:
+        return AimTurnLimit;
+    default:
+        return AimReportLimit;
+    }
+}
+
+void URpcGuardSubsystem::Kick(UNetConnection* Connection)
+{
+    ++NumKicked;
+    INC_DWORD_STAT(STAT_RpcKicks);
+
+    APlayerController* PC = Connection->PlayerController;
+    AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+
+    UE_LOG(LogShooterNet, Warning, TEXT("Kicking %s for flooding RPCs"), *Connection->LowLevelGetRemoteAddress(true));
+
+    if (PC && GameMode && GameMode->GameSession)
+    {
+        GameMode->GameSession->KickPlayer(PC, NSLOCTEXT("Shoot_N_Run", "RpcFloodKick", "Too many requests"));
+    }
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
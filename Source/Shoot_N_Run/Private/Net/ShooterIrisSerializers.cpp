@@ -0,0 +1,239 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/ShooterIrisSerializers.h"
+#include "Net/ShooterNetTypes.h"
+#include "Iris/ReplicationState/PropertyNetSerializerInfoRegistry.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamUtil.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+
+namespace UE::Net
+{
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Aim yaw, 16 bits on the wire
+struct FShooterAimYawNetSerializer
+{
+    static constexpr uint32 Version = 0;
+
+    typedef FShooterAimYaw SourceType;
+    typedef uint16 QuantizedType;
+    typedef FShooterAimYawNetSerializerConfig ConfigType;
+
+    static const ConfigType DefaultConfig;
+
+    static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+    static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+    static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+    static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+    static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+    static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+private:
+    class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+    {
+    public:
+        virtual ~FNetSerializerRegistryDelegates();
+
+    private:
+        virtual void OnPreFreezeNetSerializerRegistry() override;
+    };
+
+    static FShooterAimYawNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+};
+
+UE_NET_IMPLEMENT_SERIALIZER(FShooterAimYawNetSerializer);
+
+const FShooterAimYawNetSerializer::ConfigType FShooterAimYawNetSerializer::DefaultConfig;
+FShooterAimYawNetSerializer::FNetSerializerRegistryDelegates FShooterAimYawNetSerializer::NetSerializerRegistryDelegates;
+
+static const FName PropertyNetSerializerRegistry_NAME_ShooterAimYaw("ShooterAimYaw");
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ShooterAimYaw, FShooterAimYawNetSerializer);
+
+FShooterAimYawNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+{
+    UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ShooterAimYaw);
+}
+
+void FShooterAimYawNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+{
+    UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ShooterAimYaw);
+}
+
+void FShooterAimYawNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+    const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+    Context.GetBitStreamWriter()->WriteBits(Value, 16U);
+}
+
+void FShooterAimYawNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+    QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+    Target = static_cast<QuantizedType>(Context.GetBitStreamReader()->ReadBits(16U));
+}
+
+void FShooterAimYawNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+    const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+    QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+    Target = ShooterNet::CompressYaw(Source.Yaw);
+}
+
+void FShooterAimYawNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+    const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+    SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+    Target.Yaw = ShooterNet::DecompressYaw(Source);
+}
+
+bool FShooterAimYawNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+    if (Args.bStateIsQuantized)
+    {
+        return *reinterpret_cast<const QuantizedType*>(Args.Source0) == *reinterpret_cast<const QuantizedType*>(Args.Source1);
+    }
+
+    return *reinterpret_cast<const SourceType*>(Args.Source0) == *reinterpret_cast<const SourceType*>(Args.Source1);
+}
+
+bool FShooterAimYawNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+{
+    const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+    return FMath::IsFinite(Source.Yaw);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Projectile spawn state: packed cm origin, 16 bit yaw, 2 bit speed index, float timestamp
+struct FProjectileSpawnStateNetSerializer
+{
+    static constexpr uint32 Version = 0;
+
+    struct FQuantizedType
+    {
+        int32 Origin[3];
+        uint32 SpawnTimestamp;
+        uint16 Yaw;
+        uint8 SpeedIndex;
+    };
+
+    typedef FProjectileSpawnState SourceType;
+    typedef FQuantizedType QuantizedType;
+    typedef FProjectileSpawnStateNetSerializerConfig ConfigType;
+
+    static const ConfigType DefaultConfig;
+
+    static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+    static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+    static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+    static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+    static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+    static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+private:
+    class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+    {
+    public:
+        virtual ~FNetSerializerRegistryDelegates();
+
+    private:
+        virtual void OnPreFreezeNetSerializerRegistry() override;
+    };
+
+    static FProjectileSpawnStateNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+};
+
+UE_NET_IMPLEMENT_SERIALIZER(FProjectileSpawnStateNetSerializer);
+
+const FProjectileSpawnStateNetSerializer::ConfigType FProjectileSpawnStateNetSerializer::DefaultConfig;
+FProjectileSpawnStateNetSerializer::FNetSerializerRegistryDelegates FProjectileSpawnStateNetSerializer::NetSerializerRegistryDelegates;
+
+static const FName PropertyNetSerializerRegistry_NAME_ProjectileSpawnState("ProjectileSpawnState");
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ProjectileSpawnState, FProjectileSpawnStateNetSerializer);
+
+FProjectileSpawnStateNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+{
+    UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ProjectileSpawnState);
+}
+
+void FProjectileSpawnStateNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+{
+    UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_ProjectileSpawnState);
+}
+
+void FProjectileSpawnStateNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+    const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+    FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+    WritePackedInt32(Writer, Value.Origin[0]);
+    WritePackedInt32(Writer, Value.Origin[1]);
+    WritePackedInt32(Writer, Value.Origin[2]);
+    Writer->WriteBits(Value.Yaw, 16U);
+    Writer->WriteBits(Value.SpeedIndex, ShooterNet::ProjectileSpeedIndexBits);
+    Writer->WriteBits(Value.SpawnTimestamp, 32U);
+}
+
+void FProjectileSpawnStateNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+    QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+    FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+    Target.Origin[0] = ReadPackedInt32(Reader);
+    Target.Origin[1] = ReadPackedInt32(Reader);
+    Target.Origin[2] = ReadPackedInt32(Reader);
+    Target.Yaw = static_cast<uint16>(Reader->ReadBits(16U));
+    Target.SpeedIndex = static_cast<uint8>(Reader->ReadBits(ShooterNet::ProjectileSpeedIndexBits));
+    Target.SpawnTimestamp = Reader->ReadBits(32U);
+}
+
+void FProjectileSpawnStateNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+    const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+    QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+
+    Target.Origin[0] = FMath::RoundToInt32(Source.Origin.X);
+    Target.Origin[1] = FMath::RoundToInt32(Source.Origin.Y);
+    Target.Origin[2] = FMath::RoundToInt32(Source.Origin.Z);
+    Target.Yaw = ShooterNet::CompressYaw(Source.Yaw);
+    Target.SpeedIndex = Source.SpeedIndex;
+    Target.SpawnTimestamp = FMath::AsUInt(Source.SpawnTimestamp);
+}
+
+void FProjectileSpawnStateNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+    const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+    SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+
+    Target.Origin = FVector(Source.Origin[0], Source.Origin[1], Source.Origin[2]);
+    Target.Yaw = ShooterNet::DecompressYaw(Source.Yaw);
+    Target.SpeedIndex = Source.SpeedIndex;
+    Target.SpawnTimestamp = FMath::AsFloat(Source.SpawnTimestamp);
+}
+
+bool FProjectileSpawnStateNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+    if (Args.bStateIsQuantized)
+    {
+        const QuantizedType& Value0 = *reinterpret_cast<const QuantizedType*>(Args.Source0);
+        const QuantizedType& Value1 = *reinterpret_cast<const QuantizedType*>(Args.Source1);
+        return Value0.Origin[0] == Value1.Origin[0] && Value0.Origin[1] == Value1.Origin[1] && Value0.Origin[2] == Value1.Origin[2]
+            && Value0.Yaw == Value1.Yaw && Value0.SpeedIndex == Value1.SpeedIndex && Value0.SpawnTimestamp == Value1.SpawnTimestamp;
+    }
+
+    const SourceType& Value0 = *reinterpret_cast<const SourceType*>(Args.Source0);
+    const SourceType& Value1 = *reinterpret_cast<const SourceType*>(Args.Source1);
+    return Value0.Origin == Value1.Origin && Value0.Yaw == Value1.Yaw && Value0.SpeedIndex == Value1.SpeedIndex && Value0.SpawnTimestamp == Value1.SpawnTimestamp;
+}
+
+bool FProjectileSpawnStateNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args)
+{
+    const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+    return !Source.Origin.ContainsNaN() && FMath::IsFinite(Source.Yaw) && FMath::IsFinite(Source.SpawnTimestamp)
+        && Source.SpeedIndex < UE_ARRAY_COUNT(ShooterNet::ProjectileSpeedTable);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+}
@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/ShooterNetBenchmarkSubsystem.h"
+#include "Shoot_N_Run.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DEFINE_LOG_CATEGORY(LogShooterNet);
+
+CSV_DEFINE_CATEGORY(ShooterNet, true);
+
+static FAutoConsoleCommandWithWorldAndArgs CmdShooterNetBenchmark(
+    TEXT("ShooterNet.Benchmark"),
+    TEXT("ShooterNet.Benchmark <Seconds>: measure server replication CPU and bandwidth for the given duration"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        UShooterNetBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UShooterNetBenchmarkSubsystem>() : nullptr;
+        if (Benchmark)
+        {
+            Benchmark->StartBenchmark(Args.Num() > 0 ? FCString::Atof(*Args[0]) : 30.0f);
+        }
+    }));
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+UShooterNetBenchmarkSubsystem::UShooterNetBenchmarkSubsystem()
+    : FlushMs(0.05f, 400)
+{
+}
+
+bool UShooterNetBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    UWorld* World = Cast<UWorld>(Outer);
+    return World && World->IsGameWorld() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UShooterNetBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    float CommandLineDuration = 0.0f;
+    if (FParse::Value(FCommandLine::Get(), TEXT("NetBenchmark="), CommandLineDuration))
+    {
+        StartBenchmark(CommandLineDuration);
+    }
+}
+
+void UShooterNetBenchmarkSubsystem::Deinitialize()
+{
+    RemoveFlushTiming();
+
+#if CSV_PROFILER
+    if (bOwnsCsvCapture)
+    {
+        FCsvProfiler::Get()->EndCapture();
+        bOwnsCsvCapture = false;
+    }
+#endif
+
+    Super::Deinitialize();
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+static const TCHAR* GetReplicationMode(const UNetDriver* NetDriver)
+{
+#if UE_WITH_IRIS
+    return NetDriver->IsUsingIrisReplication() ? TEXT("Iris") : TEXT("Legacy");
+#else
+    return TEXT("Legacy");
+#endif
+}
+
+void UShooterNetBenchmarkSubsystem::StartBenchmark(float DurationSeconds)
+{
+    UWorld* World = GetWorld();
+    UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+
+    if (!NetDriver || !NetDriver->IsServer())
+    {
+        UE_LOG(LogShooterNet, Warning, TEXT("Net benchmark can only run on a server"));
+        return;
+    }
+
+    if (bRunning || DurationSeconds <= 0.0f)
+    {
+        return;
+    }
+
+    bRunning = true;
+    Duration = DurationSeconds;
+    Elapsed = 0.0f;
+    NumFrames = 0;
+    StartOutBytes = NetDriver->OutTotalBytes;
+    StartOutPackets = NetDriver->OutTotalPackets;
+    LastOutBytes = StartOutBytes;
+
+    FlushMs = FNetSoakHistogram(0.05f, 400);
+    TotalFlushMs = 0.0;
+    FlushStartTime = 0.0;
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UShooterNetBenchmarkSubsystem::OnPostActorTick);
+    PostTickFlushHandle = World->OnPostTickFlush().AddUObject(this, &UShooterNetBenchmarkSubsystem::OnPostTickFlush);
+
+    // The capture also holds the engine's NetworkOutgoing timing for a closer look at the flush
+    CsvCaptureName = TEXT("none");
+#if CSV_PROFILER
+    if (!FCsvProfiler::Get()->IsCapturing())
+    {
+        CsvCaptureName = FString::Printf(TEXT("ShooterNetBenchmark_%s_%s.csv"), GetReplicationMode(NetDriver), *FDateTime::Now().ToString());
+        FCsvProfiler::Get()->BeginCapture(-1, FPaths::ProfilingDir() / TEXT("CSV"), CsvCaptureName);
+        bOwnsCsvCapture = true;
+    }
+    else
+    {
+        // Started elsewhere, e.g. with -csvCaptureFrames, its file name is not exposed
+        CsvCaptureName = TEXT("external");
+    }
+    CSV_METADATA(TEXT("ShooterNetReplication"), GetReplicationMode(NetDriver));
+#endif
+
+    UE_LOG(LogShooterNet, Log, TEXT("Net benchmark started for %.1f seconds"), Duration);
+}
+
+void UShooterNetBenchmarkSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!bRunning)
+    {
+        return;
+    }
+
+    if (UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+    {
+        CSV_CUSTOM_STAT(ShooterNet, OutBytes, static_cast<int32>(NetDriver->OutTotalBytes - LastOutBytes), ECsvCustomStatOp::Set);
+        LastOutBytes = NetDriver->OutTotalBytes;
+    }
+
+    ++NumFrames;
+    Elapsed += DeltaTime;
+    if (Elapsed >= Duration)
+    {
+        FinishBenchmark();
+    }
+}
+
+void UShooterNetBenchmarkSubsystem::FinishBenchmark()
+{
+    bRunning = false;
+    RemoveFlushTiming();
+
+#if CSV_PROFILER
+    if (bOwnsCsvCapture)
+    {
+        FCsvProfiler::Get()->EndCapture();
+        bOwnsCsvCapture = false;
+    }
+#endif
+
+    UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+    if (!NetDriver || NumFrames == 0)
+    {
+        return;
+    }
+
+    const TCHAR* Mode = GetReplicationMode(NetDriver);
+    const int32 NumClients = NetDriver->ClientConnections.Num();
+    const double OutBytesPerSecond = static_cast<uint32>(NetDriver->OutTotalBytes - StartOutBytes) / Elapsed;
+    const double OutPacketsPerSecond = static_cast<uint32>(NetDriver->OutTotalPackets - StartOutPackets) / Elapsed;
+    const double FlushMeanMs = FlushMs.Count > 0 ? TotalFlushMs / FlushMs.Count : 0.0;
+    const float FlushP95Ms = FlushMs.Percentile(0.95f);
+
+    UE_LOG(LogShooterNet, Log, TEXT("Net benchmark [%s] clients=%d frames=%d out=%.0f B/s (%.1f pkt/s) flush mean=%.3f ms p95=%.2f ms peak=%.2f ms capture=%s"),
+        Mode, NumClients, NumFrames, OutBytesPerSecond, OutPacketsPerSecond, FlushMeanMs, FlushP95Ms, FlushMs.Max, *CsvCaptureName);
+
+    const FString CsvPath = FPaths::ProfilingDir() / TEXT("ShooterNetBenchmark.csv");
+    if (!IFileManager::Get().FileExists(*CsvPath))
+    {
+        FFileHelper::SaveStringToFile(TEXT("Mode,Clients,Seconds,Frames,OutBytesPerSec,OutPacketsPerSec,FlushMeanMs,FlushP95Ms,FlushPeakMs,CsvCapture\n"), *CsvPath);
+    }
+
+    const FString Row = FString::Printf(TEXT("%s,%d,%.1f,%d,%.0f,%.1f,%.3f,%.2f,%.2f,%s\n"),
+        Mode, NumClients, Elapsed, NumFrames, OutBytesPerSecond, OutPacketsPerSecond, FlushMeanMs, FlushP95Ms, FlushMs.Max, *CsvCaptureName);
+    FFileHelper::SaveStringToFile(Row, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+void UShooterNetBenchmarkSubsystem::OnPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld == GetWorld())
+    {
+        FlushStartTime = FPlatformTime::Seconds();
+    }
+}
+
+// PostTickFlushEvent is broadcast after every TickFlushEvent listener has run, whatever order they were bound in
+void UShooterNetBenchmarkSubsystem::OnPostTickFlush(float DeltaSeconds)
+{
+    if (FlushStartTime > 0.0)
+    {
+        const double ElapsedMs = (FPlatformTime::Seconds() - FlushStartTime) * 1000.0;
+        FlushMs.Add(ElapsedMs);
+        TotalFlushMs += ElapsedMs;
+        FlushStartTime = 0.0;
+    }
+}
+
+void UShooterNetBenchmarkSubsystem::RemoveFlushTiming()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    PostActorTickHandle.Reset();
+
+    if (UWorld* World = GetWorld())
+    {
+        World->OnPostTickFlush().Remove(PostTickFlushHandle);
+    }
+    PostTickFlushHandle.Reset();
+}
+
+TStatId UShooterNetBenchmarkSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterNetBenchmarkSubsystem, STATGROUP_Tickables);
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Net/ShooterNetTypes.h"
+#include "Engine/NetSerialization.h"
+
+uint8 ShooterNet::FindProjectileSpeedIndex(float Speed)
+{
+    uint8 BestIndex = 0;
+    for (uint8 Index = 1; Index < UE_ARRAY_COUNT(ProjectileSpeedTable); ++Index)
+    {
+        if (FMath::Abs(ProjectileSpeedTable[Index] - Speed) < FMath::Abs(ProjectileSpeedTable[BestIndex] - Speed))
+        {
+            BestIndex = Index;
+        }
+    }
+    return BestIndex;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool FShooterAimYaw::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint16 CompressedYaw = Ar.IsSaving() ? ShooterNet::CompressYaw(Yaw) : 0;
+    Ar << CompressedYaw;
+
+    if (Ar.IsLoading())
+    {
+        Yaw = ShooterNet::DecompressYaw(CompressedYaw);
+    }
+
+    bOutSuccess = true;
+    return true;
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool FProjectileSpawnState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    // 1cm precision, up to 2^20 cm from the world origin
+    bOutSuccess = SerializePackedVector<1, 20>(Origin, Ar);
+
+    uint16 CompressedYaw = Ar.IsSaving() ? ShooterNet::CompressYaw(Yaw) : 0;
+    Ar << CompressedYaw;
+
+    uint8 Index = Ar.IsSaving() ? SpeedIndex : 0;
+    Ar.SerializeBits(&Index, ShooterNet::ProjectileSpeedIndexBits);
+
+    Ar << SpawnTimestamp;
+
+    if (Ar.IsLoading())
+    {
+        Yaw = ShooterNet::DecompressYaw(CompressedYaw);
+        SpeedIndex = Index;
+    }
+
+    return true;
+}
+///////////////////////////////////////////////////////////////////////////////////////////////////
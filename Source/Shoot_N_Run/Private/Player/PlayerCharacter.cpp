@@ -2,10 +2,14 @@
 
 
 #include "Player/PlayerCharacter.h"
+#include "Player/ShooterCharacterMovementComponent.h"
+#include "Net/NetSoakSubsystem.h"
+#include "Net/RpcGuardSubsystem.h"
 #include "Engine/LocalPlayer.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
+#include "GameFramework/GameStateBase.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
@@ -18,7 +22,8 @@ DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Sets default values
-APlayerCharacter::APlayerCharacter()
+APlayerCharacter::APlayerCharacter(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer.SetDefaultSubobjectClass<UShooterCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {   
 
     // Enable replication
@@ -93,7 +98,10 @@ void APlayerCharacter::EquipWeapon()
             //Spawn and attach weapon to player
             if (HasAuthority())
             {
-                CurrentWeapon = World->SpawnActor<AWeaponBase>(WeaponClass);
+                FActorSpawnParameters SpawnParams;
+                SpawnParams.Owner = this;
+                SpawnParams.Instigator = this;
+                CurrentWeapon = World->SpawnActor<AWeaponBase>(WeaponClass, SpawnParams);
                 if (CurrentWeapon)
                 {
                     CurrentWeapon->AttachToComponent(GetMesh(), FAttachmentTransformRules::SnapToTargetIncludingScale, TEXT("RightHand"));
@@ -156,46 +164,51 @@ void APlayerCharacter::Move(const FInputActionValue& Value)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-//Sprint func call on client and server
 void APlayerCharacter::Sprint(const FInputActionValue& Value)
+{
+    SetSprinting(Value.Get<bool>());
+}
+
+//Sprint func call on client and server
+void APlayerCharacter::SetSprinting(bool bWantsSprint)
 {
     if (HasAuthority())
     {
-        HandleSprint();
+        HandleSprint(bWantsSprint);
     }
     else
     {
         //Client prediction
-        HandleSprint();
-        ServerSprint();
+        HandleSprint(bWantsSprint);
+        ServerSprint(bWantsSprint);
     }
 }
 
-void APlayerCharacter::ServerSprint_Implementation()
+void APlayerCharacter::ServerSprint_Implementation(bool bWantsSprint)
 {
-    HandleSprint();
+    if (!URpcGuardSubsystem::AllowRpc(this, ERpcKind::Sprint))
+    {
+        DeferredSprintState = bWantsSprint;
+        ScheduleDeferredInput(ERpcKind::Sprint);
+        return;
+    }
+
+    DeferredSprintState.Reset();
+    HandleSprint(bWantsSprint);
 }
 
-bool APlayerCharacter::ServerSprint_Validate()
+bool APlayerCharacter::ServerSprint_Validate(bool bWantsSprint)
 {
     return true;
 }
 
 //Sprint func
-void APlayerCharacter::HandleSprint()
+void APlayerCharacter::HandleSprint(bool bWantsSprint)
 {
-    float Speed = GetCharacterMovement()->MaxWalkSpeed;
     const float NormalSpeed = 300.0f;
     const float MaxSpeed = 500.0f;
 
-    if (Speed <= NormalSpeed)
-    {
-        GetCharacterMovement()->MaxWalkSpeed = MaxSpeed;
-    }
-    else
-    {
-        GetCharacterMovement()->MaxWalkSpeed = NormalSpeed;
-    }  
+    GetCharacterMovement()->MaxWalkSpeed = bWantsSprint ? MaxSpeed : NormalSpeed;
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -210,34 +223,88 @@ void APlayerCharacter::Shoot(const FInputActionValue& Value)
 //Call client and server shoot func according to bShouldShoot and bIsShooting
 void APlayerCharacter::ToggleShooting(bool bShouldShoot)
 {
+    AGameStateBase* GameState = GetWorld()->GetGameState();
+    const float PressTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
     if (HasAuthority())
     {
-        if (bShouldShoot && !bIsShooting)
-        {
-            bIsShooting = true;
-            HandleShoot();
-            GetWorldTimerManager().SetTimer(ShootTimerHandle, this, &APlayerCharacter::HandleShoot, 0.1f, true);
-        }
-        else if (!bShouldShoot && bIsShooting)
-        {
-            bIsShooting = false;
-            GetWorldTimerManager().ClearTimer(ShootTimerHandle);
-        }
+        SetShooting(bShouldShoot, PressTime);
     }
-    else
+    else if (bShouldShoot != bIsShooting)
     {
-        ServerShoot(bShouldShoot);
+        // Input triggers every frame while held, only send the changes
+        bIsShooting = bShouldShoot;
+        ServerShoot(bShouldShoot, PressTime);
     }
 }
 
-void APlayerCharacter::ServerShoot_Implementation(bool bShouldShoot)
+void APlayerCharacter::ServerShoot_Implementation(bool bShouldShoot, float PressTime)
 {
-    ToggleShooting(bShouldShoot);
+    if (!URpcGuardSubsystem::AllowRpc(this, ERpcKind::Shoot))
+    {
+        DeferredShootState = bShouldShoot;
+        DeferredShootPressTime = PressTime;
+        ScheduleDeferredInput(ERpcKind::Shoot);
+        return;
+    }
+
+    DeferredShootState.Reset();
+    SetShooting(bShouldShoot, PressTime);
 }
 
-bool APlayerCharacter::ServerShoot_Validate(bool bShouldShoot)
+bool APlayerCharacter::ServerShoot_Validate(bool bShouldShoot, float PressTime)
 {
-    return true;
+    return RpcValidation::Check(FMath::IsFinite(PressTime));
+}
+
+// Server side, PressTime is the server world time the trigger changed on the shooter's machine
+void APlayerCharacter::SetShooting(bool bShouldShoot, float PressTime)
+{
+    if (bShouldShoot && !bIsShooting)
+    {
+        // Every shot of the burst lags its client side timing by the same delay. The client
+        // clock is only trusted within MaxShootInputDelay
+        AGameStateBase* GameState = GetWorld()->GetGameState();
+        const float Now = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+        ShootInputDelay = FMath::Clamp(Now - PressTime, 0.0f, MaxShootInputDelay);
+
+        bIsShooting = true;
+        HandleShoot();
+        GetWorldTimerManager().SetTimer(ShootTimerHandle, this, &APlayerCharacter::HandleShoot, 0.1f, true);
+    }
+    else if (!bShouldShoot && bIsShooting)
+    {
+        bIsShooting = false;
+        GetWorldTimerManager().ClearTimer(ShootTimerHandle);
+    }
+}
+
+// Throttled state changes are kept rather than dropped, only the latest one is applied
+void APlayerCharacter::ScheduleDeferredInput(ERpcKind Kind)
+{
+    if (GetWorldTimerManager().IsTimerActive(DeferredInputTimerHandle))
+    {
+        return;
+    }
+
+    const URpcGuardSubsystem* Guard = GetWorld()->GetSubsystem<URpcGuardSubsystem>();
+    const float Delay = Guard ? Guard->GetRefillInterval(Kind) : RotationUpdateInterval;
+    GetWorldTimerManager().SetTimer(DeferredInputTimerHandle, this, &APlayerCharacter::ApplyDeferredInput, Delay, false);
+}
+
+void APlayerCharacter::ApplyDeferredInput()
+{
+    if (DeferredShootState.IsSet())
+    {
+        SetShooting(DeferredShootState.GetValue(), DeferredShootPressTime);
+        DeferredShootState.Reset();
+    }
+
+    if (DeferredSprintState.IsSet())
+    {
+        HandleSprint(DeferredSprintState.GetValue());
+        DeferredSprintState.Reset();
+    }
 }
 
 //Main shoot func
@@ -272,52 +339,80 @@ void APlayerCharacter::RotateToMouse(float DeltaTime)
             PlayerRot = UKismetMathLibrary::FindLookAtRotation(GetActorLocation(), MouseWorldPosition);
             PlayerRot.Yaw = UKismetMathLibrary::NormalizeAxis(PlayerRot.Yaw);
 
-            if (PlayerRot != rot)
-            {
-                if (HasAuthority())
-                {
-                    rot = PlayerRot;
-                    MulticastSetActorRotation(rot);
-                    if (IsLocallyControlled())
-                    {
-                        FRotator CurrentRotation = GetActorRotation();
-                        FRotator InterpolatedRotation = FMath::RInterpTo(CurrentRotation, rot, DeltaTime, RotationInterpSpeed);
-                        SetActorRotation(InterpolatedRotation);
-                    }
-                }
-                else
-                {
-                    rot = PlayerRot;
-                    ServerRotateToMouse(rot);
+            AimAt(PlayerRot, DeltaTime);
+        }
+    }
+}
 
-                    //Client prediction
-                    FRotator CurrentRotation = GetActorRotation();
-                    FRotator InterpolatedRotation = FMath::RInterpTo(CurrentRotation, rot, DeltaTime, RotationInterpSpeed);
-                    SetActorRotation(InterpolatedRotation);
-                }
-            }
+// Aim at NewRotation on server and predict it on the owning client
+void APlayerCharacter::AimAt(const FRotator& NewRotation, float DeltaTime)
+{
+    if (NewRotation != rot)
+    {
+        if (HasAuthority())
+        {
+            // Replicated to the other clients through AimYaw, the body turns towards it in Tick
+            rot = NewRotation;
+            AimYaw = FShooterAimYaw(rot);
+        }
+        else
+        {
+            // Sent to the server by SendAimToServer
+            rot = NewRotation;
+
+            //Client prediction
+            FRotator CurrentRotation = GetActorRotation();
+            FRotator InterpolatedRotation = FMath::RInterpTo(CurrentRotation, rot, DeltaTime, RotationInterpSpeed);
+            SetActorRotation(InterpolatedRotation);
         }
     }
 }
 
-void APlayerCharacter::ServerRotateToMouse_Implementation(FRotator NewRotation)
+void APlayerCharacter::SendAimToServer(float DeltaTime)
+{
+    TimeSinceLastRotationUpdate += DeltaTime;
+
+    const FShooterAimYaw Aim(rot);
+    if (TimeSinceLastRotationUpdate >= RotationUpdateInterval && Aim != LastSentAim)
+    {
+        TimeSinceLastRotationUpdate = 0.0f;
+        LastSentAim = Aim;
+        ServerRotateToMouse(Aim);
+    }
+}
+
+void APlayerCharacter::ServerRotateToMouse_Implementation(FShooterAimYaw NewAim)
 {
-    rot = NewRotation;
-    MulticastSetActorRotation(rot);
+    // Turning faster than AimTurnLimit allows is implausible for a mouse
+    const float TurnDegrees = FMath::Abs(FRotator::NormalizeAxis(NewAim.Yaw - AimYaw.Yaw));
+    if (!URpcGuardSubsystem::AllowRpc(this, ERpcKind::Rotate) || !URpcGuardSubsystem::AllowRpc(this, ERpcKind::AimTurn, TurnDegrees))
+    {
+        return;
+    }
+
+    // Replicated to the other clients through AimYaw
+    AimYaw = NewAim;
+    rot = NewAim.ToRotator();
+    SetActorRotation(rot);
+
+    if (UNetSoakSubsystem* Soak = GetWorld()->GetSubsystem<UNetSoakSubsystem>())
+    {
+        Soak->RecordAcceptedAim(this, NewAim.Yaw);
+    }
 }
 
-bool APlayerCharacter::ServerRotateToMouse_Validate(FRotator NewRotation)
+bool APlayerCharacter::ServerRotateToMouse_Validate(FShooterAimYaw NewAim)
 {
+    // Yaw arrives as 16 bits and always decompresses to a valid angle
     return true;
 }
 
-void APlayerCharacter::MulticastSetActorRotation_Implementation(FRotator NewRotation)
+void APlayerCharacter::OnRep_AimYaw()
 {
+    // Owning client predicts its own aim
     if (!IsLocallyControlled())
     {
-        //Set rotation on every client except local
-        rot = NewRotation;
-        SetActorRotation(rot);
+        rot = AimYaw.ToRotator();
     }
 }
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -329,7 +424,13 @@ void APlayerCharacter::Tick(float DeltaTime)
 
     RotateToMouse(DeltaTime);
 
-    if (!HasAuthority())
+    if (IsLocallyControlled() && !HasAuthority())
+    {
+        SendAimToServer(DeltaTime);
+    }
+
+    // Bots and the listen server host keep turning after their aim stops changing
+    if (!HasAuthority() || IsLocallyControlled())
     {
         FRotator CurrentRotation = GetActorRotation();
         FRotator InterpolatedRotation = FMath::RInterpTo(CurrentRotation, rot, DeltaTime, RotationInterpSpeed);
@@ -337,10 +438,49 @@ void APlayerCharacter::Tick(float DeltaTime)
     }
 }
 
+void APlayerCharacter::FloodServerRpcs(int32 Count)
+{
+    AGameStateBase* GameState = GetWorld()->GetGameState();
+    const float PressTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        ServerRotateToMouse(FShooterAimYaw(FRotator(0.0f, FMath::FRandRange(-180.0f, 180.0f), 0.0f)));
+        ServerShoot(Index % 2 == 0, PressTime);
+        ServerSprint(Index % 2 == 0);
+    }
+}
+
+void APlayerCharacter::ReportPredictedAim()
+{
+    if (AGameStateBase* GameState = GetWorld()->GetGameState())
+    {
+        ServerReportPredictedAim(GameState->GetServerWorldTimeSeconds(), FShooterAimYaw(rot));
+    }
+}
+
+void APlayerCharacter::ServerReportPredictedAim_Implementation(float ServerTime, FShooterAimYaw PredictedAim)
+{
+    if (!URpcGuardSubsystem::AllowRpc(this, ERpcKind::AimReport))
+    {
+        return;
+    }
+
+    // Only collected during a soak run, otherwise the report is dropped
+    if (UNetSoakSubsystem* Soak = GetWorld()->GetSubsystem<UNetSoakSubsystem>())
+    {
+        Soak->RecordPredictedAim(this, ServerTime, PredictedAim.Yaw);
+    }
+}
+
+bool APlayerCharacter::ServerReportPredictedAim_Validate(float ServerTime, FShooterAimYaw PredictedAim)
+{
+    return RpcValidation::Check(FMath::IsFinite(ServerTime));
+}
+
 void APlayerCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(APlayerCharacter, rot);
+    DOREPLIFETIME_CONDITION(APlayerCharacter, AimYaw, COND_SkipOwner);
     DOREPLIFETIME(APlayerCharacter, ShootDirection);
 }
\ No newline at end of file
@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Player/ShooterCharacterMovementComponent.h"
+#include "Net/NetSoakSubsystem.h"
+
+bool UShooterCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+    const bool bNeedsCorrection = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+
+    if (bNeedsCorrection)
+    {
+        if (UNetSoakSubsystem* Soak = GetWorld()->GetSubsystem<UNetSoakSubsystem>())
+        {
+            Soak->RecordCorrection();
+        }
+    }
+
+    return bNeedsCorrection;
+}
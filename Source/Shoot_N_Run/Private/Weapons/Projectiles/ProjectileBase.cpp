@@ -3,6 +3,9 @@
 
 #include "Weapons/Projectiles/ProjectileBase.h"
 #include "Net/UnrealNetwork.h"
+#include "GameFramework/GameStateBase.h"
+#include "Killcam/KillcamSubsystem.h"
+#include "Net/NetSoakSubsystem.h"
 
 // Sets default values
 AProjectileBase::AProjectileBase()
@@ -12,6 +15,9 @@ AProjectileBase::AProjectileBase()
 
     bReplicates = true;
 
+    // Flight is simulated locally from SpawnState, no need to replicate movement
+    SetReplicateMovement(false);
+
     if (!RootComponent)
     {
         RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("ProjectileSceneComponent"));
@@ -59,7 +65,7 @@ void AProjectileBase::BeginOverlap(UPrimitiveComponent* OverlappedComponent,
         {
             if (HasAuthority())
             {
-                ServerDestroyPlayer(Player);
+                DestroyPlayer(Player);
             }
         }
         else
@@ -67,10 +73,20 @@ void AProjectileBase::BeginOverlap(UPrimitiveComponent* OverlappedComponent,
     }
 }
 
-void AProjectileBase::ServerDestroyPlayer_Implementation(APlayerCharacter* Player)
+void AProjectileBase::DestroyPlayer(APlayerCharacter* Player)
 {
-    if (Player != nullptr)
+    if (HasAuthority() && Player != nullptr)
     {
+        if (UKillcamSubsystem* Killcam = GetWorld()->GetSubsystem<UKillcamSubsystem>())
+        {
+            Killcam->SendKillcam(Player);
+        }
+
+        if (UNetSoakSubsystem* Soak = GetWorld()->GetSubsystem<UNetSoakSubsystem>())
+        {
+            Soak->RecordHit(FireInputTime);
+        }
+
         //    
         if (Player->CurrentWeapon)
         {
@@ -93,38 +109,51 @@ void AProjectileBase::ServerDestroyPlayer_Implementation(APlayerCharacter* Playe
     }
 }
 
-bool AProjectileBase::ServerDestroyPlayer_Validate(APlayerCharacter* Player)
-{
-    return true;
-}
-
 
 
+// Server only, projectiles are spawned by AWeaponBase::ShootBullet on the server
 void AProjectileBase::FireInDirection(const FVector& ShootDirection)
 {
     if (HasAuthority())
     {
         HandleFireInDirection(ShootDirection);
     }
-    else
-    {
-        ServerFireInDirection(ShootDirection);
-    }
 }
 
-void AProjectileBase::ServerFireInDirection_Implementation(const FVector& ShootDirection)
+void AProjectileBase::HandleFireInDirection(const FVector& ShootDirection)
 {
-    HandleFireInDirection(ShootDirection);
-}
+    AGameStateBase* GameState = GetWorld()->GetGameState();
 
-bool AProjectileBase::ServerFireInDirection_Validate(const FVector& ShootDirection)
-{
-    return true;
+    // Quantize like NetSerialize does so the server copy flies the same path as the clients' copies
+    SpawnState.Origin = GetActorLocation();
+    SpawnState.Yaw = ShooterNet::DecompressYaw(ShooterNet::CompressYaw(ShootDirection.Rotation().Yaw));
+    SpawnState.SpeedIndex = ShooterNet::FindProjectileSpeedIndex(ProjectileMovementComponent->InitialSpeed);
+    SpawnState.SpawnTimestamp = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+    // Fire-to-hit is measured from the trigger press, not from the spawn
+    const APlayerCharacter* Shooter = Cast<APlayerCharacter>(GetInstigator());
+    FireInputTime = SpawnState.SpawnTimestamp - (Shooter ? Shooter->GetShootInputDelay() : 0.0f);
+
+    const FVector Velocity = SpawnState.GetDirection() * SpawnState.GetSpeed();
+    SetActorRotation(Velocity.Rotation());
+    ProjectileMovementComponent->Velocity = Velocity;
+
+    if (UKillcamSubsystem* Killcam = GetWorld()->GetSubsystem<UKillcamSubsystem>())
+    {
+        Killcam->RecordProjectileSpawn(SpawnState);
+    }
 }
 
-void AProjectileBase::HandleFireInDirection(const FVector& ShootDirection)
+void AProjectileBase::OnRep_SpawnState()
 {
-    ProjectileMovementComponent->Velocity = ShootDirection * ProjectileMovementComponent->InitialSpeed;
+    AGameStateBase* GameState = GetWorld()->GetGameState();
+    const float ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+    const float FlightTime = FMath::Max(0.0f, ServerTime - SpawnState.SpawnTimestamp);
+
+    // Catch up with the server copy that has been flying since SpawnTimestamp
+    const FVector Velocity = SpawnState.GetDirection() * SpawnState.GetSpeed();
+    SetActorLocationAndRotation(SpawnState.Origin + Velocity * FlightTime, Velocity.Rotation());
+    ProjectileMovementComponent->Velocity = Velocity;
 }
 
 // Called when the game starts or when spawned
@@ -140,3 +169,10 @@ void AProjectileBase::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
+void AProjectileBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME_CONDITION(AProjectileBase, SpawnState, COND_InitialOnly);
+}
+
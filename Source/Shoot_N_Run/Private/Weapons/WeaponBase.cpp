@@ -24,10 +24,10 @@ void AWeaponBase::ShootBullet(const FRotator rot)
     UWorld* World = GetWorld();
     if (World)
     {
+        // No owner, projectiles must not get an owning connection a client could send RPCs on
         FActorSpawnParameters SpawnParams;
-        SpawnParams.Owner = this;
         SpawnParams.Instigator = GetInstigator();
-        AProjectileBase* Projectile = World->SpawnActor<AProjectileBase>(ProjectileClass, MuzzleLocation, rot);
+        AProjectileBase* Projectile = World->SpawnActor<AProjectileBase>(ProjectileClass, MuzzleLocation, rot, SpawnParams);
         if (Projectile)
         {
             // Set the projectile's initial trajectory.				
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotDirectorSubsystem.generated.h"
+
+class AShooterBotController;
+
+// Server side backfill of empty lobby slots with AShooterBotController bots. Bot perception
+// is time sliced: each frame bots are visited round robin until PerceptionBudgetUs is used
+// up, and at most MaxPathRequestsPerFrame async path queries are started, so their cost per
+// frame stays flat however many bots are in the match. Steering is a few vector ops per bot
+// and runs for every bot each frame, counted under the Bot Steering stat.
+UCLASS(config = Game)
+class SHOOT_N_RUN_API UBotDirectorSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    UPROPERTY(config)
+    bool bEnableBackfill = true;
+
+    // Humans plus bots, 3v3
+    UPROPERTY(config)
+    int32 LobbySize = 6;
+
+    UPROPERTY(config)
+    float PerceptionBudgetUs = 150.0f;
+
+    UPROPERTY(config)
+    int32 MaxPathRequestsPerFrame = 2;
+
+    UPROPERTY(config)
+    float BackfillInterval = 2.0f;
+
+    UPROPERTY(config)
+    TSoftClassPtr<AShooterBotController> BotControllerClass;
+
+private:
+    void UpdateBackfill();
+    void TickPerception(float Now);
+    void TickPathRequests(float Now);
+
+    UPROPERTY(Transient)
+    TArray<AShooterBotController*> Bots;
+
+    int32 PerceptionCursor = 0;
+    int32 PathCursor = 0;
+    float TimeSinceBackfill = 0.0f;
+};
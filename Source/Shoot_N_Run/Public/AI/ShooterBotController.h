@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "WorldCollision.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "ShooterBotController.generated.h"
+
+class APlayerCharacter;
+
+// Backfill bot for APlayerCharacter. Drives the character through the same Move, AimAt and
+// ToggleShooting paths as a player. The controller does not tick: UBotDirectorSubsystem calls
+// TickBot every frame and UpdatePerception and RequestPath inside its per-frame budget, and
+// perception and pathfinding complete asynchronously.
+UCLASS(config = Game)
+class SHOOT_N_RUN_API AShooterBotController : public AAIController
+{
+    GENERATED_BODY()
+
+public:
+    AShooterBotController();
+
+    // Steering and firing
+    void TickBot(float DeltaTime);
+
+    bool IsPerceptionDue(float Now) const { return GetPawn() && Now >= NextPerceptionTime; }
+
+    // Pick the nearest enemy and queue an async line of sight trace to it
+    void UpdatePerception(float Now);
+
+    bool WantsPath(float Now) const;
+
+    // Queue an async navmesh query towards the current target
+    void RequestPath(float Now);
+
+    bool IsPathInFlight() const { return bPathInFlight; }
+
+protected:
+    virtual void OnUnPossess() override;
+
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float PerceptionInterval = 0.25f;
+
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float SightRadius = 3000.0f;
+
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float FireRange = 1500.0f;
+
+    // Bots stop closing in once a visible target is this close
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float PreferredRange = 800.0f;
+
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float AimToleranceDegrees = 10.0f;
+
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float AcceptanceRadius = 80.0f;
+
+    // Repath when the target moved this far from the end of the current path
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float RepathDistance = 300.0f;
+
+    UPROPERTY(config, EditDefaultsOnly, Category = "Bot")
+    float RepathInterval = 1.0f;
+
+private:
+    APlayerCharacter* FindNearestEnemy() const;
+
+    void OnSightTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum, TWeakObjectPtr<APlayerCharacter> Candidate);
+    void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+    TWeakObjectPtr<APlayerCharacter> Target;
+    bool bTargetVisible = false;
+    float NextPerceptionTime = 0.0f;
+
+    TArray<FVector> PathPoints;
+    int32 PathIndex = 0;
+    bool bPathInFlight = false;
+    float LastPathRequestTime = -BIG_NUMBER;
+};
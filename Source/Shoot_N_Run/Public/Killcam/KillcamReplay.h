@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Killcam/KillcamTypes.h"
+#include "KillcamReplay.generated.h"
+
+class UCameraComponent;
+class UInstancedStaticMeshComponent;
+class UStaticMeshComponent;
+
+// Carries a killcam clip to the victim and plays it back. Only relevant to its owner. The clip
+// goes out as reliable client RPCs in small chunks, rate limited and held back while the
+// connection is saturated; playback moves lightweight mesh components instead of spawning
+// characters or projectiles.
+UCLASS()
+class SHOOT_N_RUN_API AKillcamReplay : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AKillcamReplay();
+
+    // Server: queue the encoded clip for sending to the owning connection, or play it right away
+    // when the owner is the listen server host
+    void StartStreaming(TArray<uint8>&& InClipBytes, int64 InClipBits, float ClipDuration);
+
+    virtual void Tick(float DeltaTime) override;
+
+protected:
+    UPROPERTY(VisibleAnywhere, Category = "Killcam")
+    USceneComponent* SceneRoot;
+
+    UPROPERTY(VisibleAnywhere, Category = "Killcam")
+    UCameraComponent* Camera;
+
+    UPROPERTY(VisibleAnywhere, Category = "Killcam")
+    UInstancedStaticMeshComponent* ProjectileInstances;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Killcam")
+    UStaticMesh* CharacterMesh;
+
+    // Upper bound on clip bytes sent per second, keeps the reliable buffer clear for gameplay
+    UPROPERTY(EditDefaultsOnly, Category = "Killcam")
+    int32 BytesPerSecond = 8192;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Killcam")
+    int32 ChunkBytes = 512;
+
+    // Stop sending chunks while this many of our reliable bunches are still unacked
+    UPROPERTY(EditDefaultsOnly, Category = "Killcam")
+    int32 MaxOutstandingChunks = 8;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Killcam")
+    float CameraHeight = 1500.0f;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Killcam")
+    float ProjectileLifetime = 1.5f;
+
+    UFUNCTION(Client, Reliable)
+    void ClientBeginClip(int32 TotalBytes, int64 NumBits);
+
+    UFUNCTION(Client, Reliable)
+    void ClientReceiveChunk(const TArray<uint8>& Chunk);
+
+private:
+    void TickStreaming(float DeltaTime);
+    void StartPlayback();
+    void TickPlayback(float DeltaTime);
+    void StopPlayback();
+
+    // Server
+    TArray<uint8> ClipBytes;
+    int64 ClipBits = 0;
+    int32 BytesSent = 0;
+    float SendAllowance = 0.0f;
+    float PlaybackSeconds = 0.0f;
+
+    // Client
+    TArray<uint8> ReceivedBytes;
+    int32 ExpectedBytes = 0;
+    int64 ExpectedBits = 0;
+
+    TArray<FKillcamFrame> PlaybackFrames;
+    uint8 VictimId = 0;
+    float PlaybackTime = 0.0f;
+    bool bPlaying = false;
+
+    UPROPERTY(Transient)
+    TMap<uint8, UStaticMeshComponent*> CharacterProxies;
+};
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Killcam/KillcamTypes.h"
+#include "KillcamSubsystem.generated.h"
+
+class AKillcamReplay;
+class APlayerCharacter;
+struct FProjectileSpawnState;
+
+// Server side recorder for killcams. Keeps the last seconds of character transforms, aim yaw
+// and projectile spawns in a ring buffer of fixed size frames allocated once from a memory
+// budget, and on death streams a delta-compressed clip to the victim through an AKillcamReplay.
+UCLASS(config = Game)
+class SHOOT_N_RUN_API UKillcamSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void RecordProjectileSpawn(const FProjectileSpawnState& SpawnState);
+
+    // Build a clip of the last ClipSeconds and start streaming it to the victim's connection
+    void SendKillcam(APlayerCharacter* Victim);
+
+protected:
+    // Memory the ring buffer may use
+    UPROPERTY(config)
+    int32 MemoryBudgetKB = 128;
+
+    UPROPERTY(config)
+    float SampleRate = 20.0f;
+
+    // Length of the clip sent to the victim, capped by what the budget can hold
+    UPROPERTY(config)
+    float ClipSeconds = 5.0f;
+
+    UPROPERTY(config)
+    TSoftClassPtr<AKillcamReplay> ReplayClass;
+
+private:
+    void RecordFrame(float Time);
+
+    // Returns false when all ids are taken or still referenced by buffered frames
+    bool GetCharacterId(const APlayerCharacter* Character, uint8& OutId);
+    void PruneCharacterIds();
+
+    TArray<FKillcamFrame> Frames;
+
+    // Index of the oldest frame and number of valid frames
+    int32 Head = 0;
+    int32 Count = 0;
+
+    // Spawns since the last sample, flushed into the next frame
+    FKillcamFrame PendingProjectiles;
+
+    TMap<FObjectKey, uint8> CharacterIds;
+    int32 NextCharacterId = 0;
+
+    // Ids of characters that went away, oldest first, with the frame they were freed on. An id
+    // is handed out again only once every buffered frame that could contain it is overwritten
+    TArray<TPair<uint8, int64>> FreedCharacterIds;
+    int64 NumRecordedFrames = 0;
+
+    float TimeSinceLastSample = 0.0f;
+};
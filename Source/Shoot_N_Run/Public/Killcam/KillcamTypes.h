@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FProjectileSpawnState;
+
+namespace Killcam
+{
+    // 3v3 plus spectators/bots headroom
+    inline constexpr int32 MaxCharacters = 8;
+
+    // Spawns beyond this within one sample interval are dropped from the recording
+    inline constexpr int32 MaxProjectilesPerFrame = 8;
+}
+
+// Character transform quantized to 1cm and a 16 bit yaw
+struct FKillcamCharacterSample
+{
+    int32 X = 0;
+    int32 Y = 0;
+    int16 Z = 0;
+    uint16 Yaw = 0;
+    uint8 Id = 0;
+};
+
+// Projectile fired during the frame, replayed as a straight line
+struct FKillcamProjectileSample
+{
+    int32 X = 0;
+    int32 Y = 0;
+    int16 Z = 0;
+    uint16 Yaw = 0;
+    uint8 SpeedIndex = 0;
+};
+
+// One fixed size recorded frame, the ring buffer is a preallocated array of these
+struct FKillcamFrame
+{
+    float Time = 0.0f;
+    uint8 NumCharacters = 0;
+    uint8 NumProjectiles = 0;
+    FKillcamCharacterSample Characters[Killcam::MaxCharacters];
+    FKillcamProjectileSample Projectiles[Killcam::MaxProjectilesPerFrame];
+
+    void AddCharacter(uint8 Id, const FVector& Location, float Yaw);
+    bool AddProjectile(const FProjectileSpawnState& SpawnState);
+
+    const FKillcamCharacterSample* FindCharacter(uint8 Id) const;
+};
+
+namespace Killcam
+{
+    // Delta-compresses Frames (oldest first) against the previous frame of each character
+    SHOOT_N_RUN_API void EncodeClip(const TArray<const FKillcamFrame*>& Frames, uint8 VictimId, TArray<uint8>& OutBytes, int64& OutNumBits);
+
+    // Returns false on a malformed clip
+    SHOOT_N_RUN_API bool DecodeClip(const TArray<uint8>& Bytes, int64 NumBits, TArray<FKillcamFrame>& OutFrames, uint8& OutVictimId);
+}
@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "NetSoakSubsystem.generated.h"
+
+class APlayerCharacter;
+
+// Packet simulation applied to every net driver in the soak run
+USTRUCT()
+struct FNetSoakProfile
+{
+    GENERATED_BODY()
+
+    UPROPERTY(config)
+    FName Name;
+
+    // Milliseconds
+    UPROPERTY(config)
+    int32 PktLag = 0;
+
+    UPROPERTY(config)
+    int32 PktLagVariance = 0;
+
+    // Percent
+    UPROPERTY(config)
+    int32 PktLoss = 0;
+
+    UPROPERTY(config)
+    int32 PktDup = 0;
+};
+
+// Fixed bin histogram, memory stays constant however long the soak runs
+struct FNetSoakHistogram
+{
+    FNetSoakHistogram(float InBinSize, int32 NumBins) : BinSize(InBinSize) { Bins.SetNumZeroed(NumBins); }
+
+    void Add(float Value);
+    float Percentile(float Fraction) const;
+
+    float BinSize;
+    TArray<uint32> Bins;
+    uint32 Count = 0;
+    float Max = 0.0f;
+};
+
+// Network impairment soak run. Only exists when the process is started with -NetSoak.
+// Launch a server and N headless clients with the same -NetSoakProfile=<Name>; clients drive
+// their character with random movement, aim, fire and sprint, the server collects corrections,
+// reliable buffer occupancy, saturation, aim divergence (the client's predicted aim against
+// the aim the server had accepted at the same server time) and fire-to-hit latency, then writes
+// Saved/NetSoak/<Profile>.txt after -NetSoakDuration=<Seconds> and exits non zero if any
+// threshold is exceeded. With -NetSoakFlood=<RpcsPerFrame> clients also flood server RPCs to
+// check that the server's frame time stays bounded while the RPC guard throttles them. Killed players are restarted
+// after RespawnDelay so every client keeps sending traffic for the whole run.
+// Scripts/RunNetSoak.py launches the server and clients, waits for the report and returns
+// the server's exit code.
+UCLASS(config = Game)
+class SHOOT_N_RUN_API UNetSoakSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UNetSoakSubsystem();
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void RecordCorrection();
+    void RecordAcceptedAim(APlayerCharacter* Character, float Yaw);
+    void RecordPredictedAim(APlayerCharacter* Character, float ServerTime, float PredictedYaw);
+    // Latency from the client pressing the trigger to the server registering the hit
+    void RecordHit(float FireInputTime);
+
+protected:
+    UPROPERTY(config)
+    TArray<FNetSoakProfile> Profiles;
+
+    UPROPERTY(config)
+    float MaxCorrectionsPerMinute = 30.0f;
+
+    // Fraction of the reliable buffer in use on the fullest channel
+    UPROPERTY(config)
+    float MaxReliableBufferOccupancy = 0.5f;
+
+    UPROPERTY(config)
+    int32 MaxSaturationEvents = 50;
+
+    UPROPERTY(config)
+    float MaxAimDivergenceP95 = 20.0f;
+
+    UPROPERTY(config)
+    float MaxFireToHitP95Ms = 400.0f;
+
+    // Server game thread work per frame, idle time waiting for the tick rate excluded. Covers
+    // receiving, deserializing and dispatching flooded RPCs as well as kicks
+    UPROPERTY(config)
+    float MaxServerFrameP95Ms = 20.0f;
+
+    UPROPERTY(config)
+    float MaxServerFramePeakMs = 100.0f;
+
+    // The game has no respawn of its own
+    UPROPERTY(config)
+    float RespawnDelay = 2.0f;
+
+private:
+    void ApplyProfile();
+    void TickServer(float DeltaTime);
+    void TickClient(float DeltaTime);
+    void RespawnPlayers();
+    void FinishSoak();
+
+    FNetSoakProfile Profile;
+
+    float Duration = 300.0f;
+    float Elapsed = 0.0f;
+    bool bFinished = false;
+
+    // Server metrics
+    int32 NumCorrections = 0;
+    int32 NumSaturationEvents = 0;
+    float PeakReliableOccupancy = 0.0f;
+    int32 PeakClients = 0;
+    FNetSoakHistogram AimDivergence;
+    FNetSoakHistogram FireToHitMs;
+    FNetSoakHistogram ServerFrameMs;
+
+    TMap<FObjectKey, bool> SaturatedConnections;
+
+    // Elapsed time each player controller lost its pawn at
+    TMap<FObjectKey, float> PawnlessSince;
+
+    // Recent aims accepted by the server per character, oldest first, about 3 s at the 20 Hz send rate
+    static constexpr int32 MaxAcceptedAims = 64;
+    struct FAcceptedAim
+    {
+        float ServerTime = 0.0f;
+        float Yaw = 0.0f;
+    };
+    TMap<FObjectKey, TArray<FAcceptedAim>> AcceptedAims;
+
+    // Client input driver
+    FVector2D DriveInput = FVector2D::ZeroVector;
+    float DriveYaw = 0.0f;
+    float DriveTargetYaw = 0.0f;
+    float TimeToNextDriveChange = 0.0f;
+    float TimeToNextAimReport = 0.0f;
+
+    // Degrees per second, a brisk mouse sweep
+    float DriveTurnRate = 180.0f;
+    float AimReportInterval = 0.1f;
+
+    int32 FloodRpcsPerFrame = 0;
+};
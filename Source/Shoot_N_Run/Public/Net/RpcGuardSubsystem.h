@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "RpcGuardSubsystem.generated.h"
+
+// Client RPCs that are rate limited separately
+enum class ERpcKind : uint8
+{
+    Shoot,
+    Sprint,
+    Rotate,
+    // Cost is the aim change in degrees, bounds how fast a client can turn
+    AimTurn,
+    // Net soak predicted aim reports
+    AimReport,
+    Count
+};
+
+USTRUCT()
+struct FRpcRateLimit
+{
+    GENERATED_BODY()
+
+    FRpcRateLimit() = default;
+    FRpcRateLimit(float InRatePerSecond, float InBurst) : RatePerSecond(InRatePerSecond), Burst(InBurst) {}
+
+    UPROPERTY(config)
+    float RatePerSecond = 10.0f;
+
+    UPROPERTY(config)
+    float Burst = 10.0f;
+};
+
+namespace RpcValidation
+{
+    // Counts the RPCs failing their _Validate, which disconnects the sender
+    SHOOT_N_RUN_API bool Check(bool bValid);
+}
+
+// Per-connection token buckets for client to server RPCs. Every check is a map lookup and
+// a refill, so the cost per RPC stays constant however hard a client floods. Over-budget
+// RPCs are counted as violations and dropped, except that callers keep the latest state of
+// stateful inputs (shoot, sprint) to apply later; a connection that keeps violating is kicked.
+UCLASS(config = Game)
+class SHOOT_N_RUN_API URpcGuardSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Returns false when the RPC received on Caller's connection should be dropped
+    static bool AllowRpc(const AActor* Caller, ERpcKind Kind, float Cost = 1.0f);
+
+    // Time for one token of Kind to refill, the earliest a throttled state change can be applied
+    float GetRefillInterval(ERpcKind Kind) const { return 1.0f / FMath::Max(GetLimit(Kind).RatePerSecond, KINDA_SMALL_NUMBER); }
+
+    int32 GetNumThrottled() const { return NumThrottled; }
+    int32 GetNumKicked() const { return NumKicked; }
+    double GetPeakFrameMs() const { return PeakFrameMs; }
+
+protected:
+    UPROPERTY(config)
+    FRpcRateLimit ShootLimit = FRpcRateLimit(10.0f, 10.0f);
+
+    // Two RPCs per tap, press and release
+    UPROPERTY(config)
+    FRpcRateLimit SprintLimit = FRpcRateLimit(10.0f, 10.0f);
+
+    UPROPERTY(config)
+    FRpcRateLimit RotateLimit = FRpcRateLimit(40.0f, 20.0f);
+
+    UPROPERTY(config)
+    FRpcRateLimit AimTurnLimit = FRpcRateLimit(3600.0f, 720.0f);
+
+    // The soak driver reports ten times a second
+    UPROPERTY(config)
+    FRpcRateLimit AimReportLimit = FRpcRateLimit(20.0f, 10.0f);
+
+    // Violations a connection may accumulate before it is kicked
+    UPROPERTY(config)
+    float KickViolations = 200.0f;
+
+    UPROPERTY(config)
+    float ViolationDecayPerSecond = 5.0f;
+
+private:
+    struct FTokenBucket
+    {
+        float Tokens = -1.0f;
+        double LastRefillTime = 0.0;
+    };
+
+    struct FConnectionBudget
+    {
+        FTokenBucket Buckets[static_cast<uint8>(ERpcKind::Count)];
+        float Violations = 0.0f;
+        double LastViolationTime = 0.0;
+        bool bKicked = false;
+    };
+
+    bool Consume(class UNetConnection* Connection, ERpcKind Kind, float Cost);
+    const FRpcRateLimit& GetLimit(ERpcKind Kind) const;
+    void Kick(class UNetConnection* Connection);
+
+    TMap<FObjectKey, FConnectionBudget> Budgets;
+
+    int32 NumThrottled = 0;
+    int32 NumKicked = 0;
+
+    uint32 CyclesThisFrame = 0;
+    double PeakFrameMs = 0.0;
+    float TimeSincePrune = 0.0f;
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Iris/Serialization/NetSerializer.h"
+#include "ShooterIrisSerializers.generated.h"
+
+// Iris serializers for the types in Net/ShooterNetTypes.h. They are registered for the structs
+// so Iris picks them up automatically when net.Iris.UseIrisReplication is enabled.
+
+USTRUCT()
+struct FShooterAimYawNetSerializerConfig : public FNetSerializerConfig
+{
+    GENERATED_BODY()
+};
+
+USTRUCT()
+struct FProjectileSpawnStateNetSerializerConfig : public FNetSerializerConfig
+{
+    GENERATED_BODY()
+};
+
+namespace UE::Net
+{
+    UE_NET_DECLARE_SERIALIZER(FShooterAimYawNetSerializer, SHOOT_N_RUN_API);
+    UE_NET_DECLARE_SERIALIZER(FProjectileSpawnStateNetSerializer, SHOOT_N_RUN_API);
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Net/NetSoakSubsystem.h"
+#include "ShooterNetBenchmarkSubsystem.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogShooterNet, Log, All);
+
+// Server side replication benchmark. Measures outgoing bandwidth and net flush CPU over a fixed
+// window and records a CSV profiler capture for the same window, so runs with legacy replication
+// and with Iris can be compared. Flush time runs from the end of actor ticks to the end of the
+// net driver flush, which bounds NetDriver::TickFlush without relying on delegate binding order.
+// Start with "ShooterNet.Benchmark <Seconds>" on the server, or launch with -NetBenchmark=<Seconds>.
+// Each run is appended to Saved/Profiling/ShooterNetBenchmark.csv with the name of its capture.
+UCLASS()
+class SHOOT_N_RUN_API UShooterNetBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UShooterNetBenchmarkSubsystem();
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void StartBenchmark(float DurationSeconds);
+
+    bool IsRunning() const { return bRunning; }
+
+private:
+    void FinishBenchmark();
+
+    void OnPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    void OnPostTickFlush(float DeltaSeconds);
+    void RemoveFlushTiming();
+
+    bool bRunning = false;
+
+    // Only end captures we started, a capture begun with -csvCaptureFrames is left alone
+    bool bOwnsCsvCapture = false;
+    FString CsvCaptureName;
+
+    float Duration = 0.0f;
+    float Elapsed = 0.0f;
+
+    int32 NumFrames = 0;
+
+    uint32 StartOutBytes = 0;
+    uint32 StartOutPackets = 0;
+    uint32 LastOutBytes = 0;
+
+    FDelegateHandle PostActorTickHandle;
+    FDelegateHandle PostTickFlushHandle;
+
+    double FlushStartTime = 0.0;
+    double TotalFlushMs = 0.0;
+    FNetSoakHistogram FlushMs;
+};
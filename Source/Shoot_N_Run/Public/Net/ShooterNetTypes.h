@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterNetTypes.generated.h"
+
+namespace ShooterNet
+{
+    // Projectile speeds addressable by FProjectileSpawnState::SpeedIndex (2 bits on the wire)
+    inline constexpr float ProjectileSpeedTable[] = { 2000.0f, 3000.0f, 4000.0f, 6000.0f };
+    inline constexpr uint32 ProjectileSpeedIndexBits = 2;
+
+    // Index of the table entry closest to Speed
+    SHOOT_N_RUN_API uint8 FindProjectileSpeedIndex(float Speed);
+
+    // Yaw in degrees <-> 16 bit fixed point, shared by the legacy and Iris serializers
+    FORCEINLINE uint16 CompressYaw(float Yaw) { return FRotator::CompressAxisToShort(Yaw); }
+    FORCEINLINE float DecompressYaw(uint16 Yaw) { return FRotator::NormalizeAxis(FRotator::DecompressAxisFromShort(Yaw)); }
+}
+
+// Yaw-only aim of a top-down character, sent as 16 bits instead of a full FRotator
+USTRUCT()
+struct SHOOT_N_RUN_API FShooterAimYaw
+{
+    GENERATED_BODY()
+
+    FShooterAimYaw() = default;
+    explicit FShooterAimYaw(const FRotator& Rotation) : Yaw(FRotator::NormalizeAxis(Rotation.Yaw)) {}
+
+    UPROPERTY()
+    float Yaw = 0.0f;
+
+    FRotator ToRotator() const { return FRotator(0.0f, Yaw, 0.0f); }
+
+    bool operator==(const FShooterAimYaw& Other) const { return ShooterNet::CompressYaw(Yaw) == ShooterNet::CompressYaw(Other.Yaw); }
+    bool operator!=(const FShooterAimYaw& Other) const { return !(*this == Other); }
+
+    // Legacy replication path
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterAimYaw> : public TStructOpsTypeTraitsBase2<FShooterAimYaw>
+{
+    enum
+    {
+        WithNetSerializer = true,
+        WithIdenticalViaEquality = true,
+    };
+};
+
+// Everything a client needs to simulate a straight-flying projectile on its own
+USTRUCT()
+struct SHOOT_N_RUN_API FProjectileSpawnState
+{
+    GENERATED_BODY()
+
+    // Muzzle location, 1cm precision on the wire
+    UPROPERTY()
+    FVector Origin = FVector::ZeroVector;
+
+    UPROPERTY()
+    float Yaw = 0.0f;
+
+    // Index into ShooterNet::ProjectileSpeedTable
+    UPROPERTY()
+    uint8 SpeedIndex = 0;
+
+    // Server world time the projectile was fired at
+    UPROPERTY()
+    float SpawnTimestamp = 0.0f;
+
+    FVector GetDirection() const { return FRotator(0.0f, Yaw, 0.0f).Vector(); }
+    float GetSpeed() const { return ShooterNet::ProjectileSpeedTable[FMath::Min<uint32>(SpeedIndex, UE_ARRAY_COUNT(ShooterNet::ProjectileSpeedTable) - 1)]; }
+
+    // Legacy replication path
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FProjectileSpawnState> : public TStructOpsTypeTraitsBase2<FProjectileSpawnState>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
@@ -6,10 +6,14 @@
 #include "GameFramework/Character.h"
 #include "InputActionValue.h"
 #include "Weapons\WeaponBase.h"
+#include "Net/ShooterNetTypes.h"
+#include "Engine/NetSerialization.h"
 #include "PlayerCharacter.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
+enum class ERpcKind : uint8;
+
 UCLASS(config = Game)
 class SHOOT_N_RUN_API APlayerCharacter : public ACharacter
 {
@@ -17,7 +21,28 @@ class SHOOT_N_RUN_API APlayerCharacter : public ACharacter
 
 public:
     // Sets default values for this character's properties
-    APlayerCharacter();   
+    APlayerCharacter(const FObjectInitializer& ObjectInitializer);
+
+    // Function to move the character, also used by bots
+    void Move(const FInputActionValue& Value);
+
+    // Start or stop automatic fire, callable from input and from code driving the character
+    void ToggleShooting(bool bShouldShoot);
+
+    // Start or stop sprinting, callable from input and from code driving the character
+    void SetSprinting(bool bWantsSprint);
+
+    // Function to rotate the player towards an aim rotation
+    void AimAt(const FRotator& NewRotation, float DeltaTime);
+
+    // Sends Count junk server RPCs at once, used by the net soak flood run
+    void FloodServerRpcs(int32 Count);
+
+    // Sends the predicted aim stamped with server time, used by the net soak run
+    void ReportPredictedAim();
+
+    // Server side delay between the trigger press on the shooter's machine and the first shot
+    float GetShootInputDelay() const { return ShootInputDelay; }
     
 protected:
     // Called when the game starts or when spawned
@@ -36,11 +61,15 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon")
     AWeaponBase* CurrentWeapon;
 
-    UPROPERTY(Replicated)
+    // Aim rotation, only the yaw is used
     FRotator rot;
 
+    // Quantized aim replicated to simulated proxies
+    UPROPERTY(ReplicatedUsing = OnRep_AimYaw)
+    FShooterAimYaw AimYaw;
+
     UPROPERTY(Replicated)
-    FVector ShootDirection;
+    FVector_NetQuantizeNormal ShootDirection;
 
 protected:
 
@@ -62,19 +91,22 @@ protected:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
     class UInputAction* ShootAction;
 
-    // Server function to handle sprinting
+    // Server function to handle sprinting, sends the wanted state rather than a toggle
     UFUNCTION(Server, Reliable, WithValidation)
-    void ServerSprint();
+    void ServerSprint(bool bWantsSprint);
 
-    // Server function to handle shooting
+    // Server function to handle shooting, PressTime is the client's server world time of the input
     UFUNCTION(Server, Reliable, WithValidation)
-    void ServerShoot(bool bShouldShoot);
+    void ServerShoot(bool bShouldShoot, float PressTime);
 
     UFUNCTION(Server, Reliable, WithValidation)
-    void ServerRotateToMouse(FRotator NewRotation);
+    void ServerRotateToMouse(FShooterAimYaw NewAim);
 
-    UFUNCTION(NetMulticast, Reliable)
-    void MulticastSetActorRotation(FRotator NewRotation);
+    UFUNCTION(Server, Unreliable, WithValidation)
+    void ServerReportPredictedAim(float ServerTime, FShooterAimYaw PredictedAim);
+
+    UFUNCTION()
+    void OnRep_AimYaw();
 
     // Called every frame
     virtual void Tick(float DeltaTime) override;
@@ -82,18 +114,16 @@ protected:
     // Called to bind functionality to input
     virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
-    // Function to move the character
-    void Move(const FInputActionValue& Value);
-
     // Function to handle sprinting
     void Sprint(const FInputActionValue& Value);
 
     void Shoot(const FInputActionValue& Value);
 
-    void ToggleShooting(bool bShouldShoot);
-
     // Function to handle the sprint logic
-    void HandleSprint();
+    void HandleSprint(bool bWantsSprint);
+
+    // Function to start or stop automatic fire on the server
+    void SetShooting(bool bShouldShoot, float PressTime);
 
     // Function to handle the shooting logic
     void HandleShoot();
@@ -101,6 +131,9 @@ protected:
     // Function to rotate the player to the mouse cursor
     void RotateToMouse(float DeltaTime);
 
+    // Function to send the predicted aim to the server
+    void SendAimToServer(float DeltaTime);
+
     // Function to get lifetime replicated properties
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
@@ -123,4 +156,20 @@ private:
 
     float TimeSinceLastRotationUpdate = 0.0f;
 
+    FShooterAimYaw LastSentAim;
+
+    float ShootInputDelay = 0.0f;
+
+    float MaxShootInputDelay = 1.0f;
+
+    // Latest shoot and sprint state the RPC guard throttled, applied once the rate limit allows
+    // so the server never stays out of sync with the client
+    TOptional<bool> DeferredShootState;
+    float DeferredShootPressTime = 0.0f;
+    TOptional<bool> DeferredSprintState;
+    FTimerHandle DeferredInputTimerHandle;
+
+    void ScheduleDeferredInput(ERpcKind Kind);
+    void ApplyDeferredInput();
+
 };
\ No newline at end of file
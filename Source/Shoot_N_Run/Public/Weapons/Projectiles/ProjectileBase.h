@@ -8,6 +8,7 @@
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/PrimitiveComponent.h"
 #include "Player\PlayerCharacter.h"
+#include "Net/ShooterNetTypes.h"
 #include "ProjectileBase.generated.h"
 
 UCLASS()
@@ -29,13 +30,20 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = Movement)
 	UProjectileMovementComponent* ProjectileMovementComponent;
 
-	void HandleFireInDirection(const FVector& ShootDirection);
+	// Replicated instead of movement, clients simulate the flight from it
+	UPROPERTY(ReplicatedUsing = OnRep_SpawnState)
+	FProjectileSpawnState SpawnState;
+
+	UFUNCTION()
+	void OnRep_SpawnState();
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerFireInDirection(const FVector& ShootDirection);
+	// Server only, server world time of the trigger press that fired this projectile
+	float FireInputTime = 0.0f;
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerDestroyPlayer (APlayerCharacter* Player);
+	void HandleFireInDirection(const FVector& ShootDirection);
+
+	// Server only, called from the authoritative overlap
+	void DestroyPlayer(APlayerCharacter* Player);
 
 	UFUNCTION()
 	void BeginOverlap(UPrimitiveComponent* OverlappedComponent,
@@ -53,4 +61,6 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 };
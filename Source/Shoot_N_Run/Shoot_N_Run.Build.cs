@@ -19,13 +19,19 @@ public class Shoot_N_Run : ModuleRules
             "OnlineSubsystem",
             "OnlineSubsystemUtils",
             "Networking",
-            "Sockets" 
+            "Sockets",
+            "AIModule",
+            "NavigationSystem",
+            "GameplayTasks"
 		});
 
 		PrivateDependencyModuleNames.AddRange(new string[] { 
-			
+			"NetCore"
 		});
 
+		// Iris is compiled in, but only used when net.Iris.UseIrisReplication is enabled
+		SetupIrisSupport(Target);
+
         // Uncomment if you are using Slate UI
         // PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 
@@ -4,3 +4,5 @@
 
 #include "CoreMinimal.h"
 
+DECLARE_STATS_GROUP(TEXT("Shoot_N_Run"), STATGROUP_ShootNRun, STATCAT_Advanced);
+